@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_BOOT_HANDOFF_
+#define H_BOOT_HANDOFF_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/sys/crc.h>
+
+#define BOOT_HANDOFF_MAGIC      0x46484F42 /* "BOHF" */
+#define BOOT_HANDOFF_VERSION    1
+
+/** Why the application was started, judged against the previous boot */
+enum boot_reason {
+	/** No record of a previous boot, retained RAM was lost */
+	BOOT_REASON_COLD = 0,
+	/** Same image as on the previous boot */
+	BOOT_REASON_RESET,
+	/** A new image was installed or is newer than the previous one */
+	BOOT_REASON_UPDATE,
+	/** The image is older than the one started on the previous boot */
+	BOOT_REASON_ROLLBACK,
+};
+
+/** Why cpurad_boot entered DFU mode on this boot */
+enum boot_dfu_reason {
+	BOOT_DFU_NONE = 0,
+	BOOT_DFU_STRAP,
+	BOOT_DFU_REQUESTED,
+	BOOT_DFU_NO_IMAGE,
+};
+
+/** How the started image was checked against its header digest */
+enum boot_verify {
+	BOOT_VERIFY_NONE = 0,
+	/** The image was hashed on this boot */
+	BOOT_VERIFY_DIGEST,
+	/** Taken from the verified-image cache, the header was hashed */
+	BOOT_VERIFY_CACHED,
+};
+
+/** Same layout as struct image_version in the image header */
+struct boot_handoff_version {
+	uint8_t major;
+	uint8_t minor;
+	uint16_t revision;
+	uint32_t build;
+};
+
+/**
+ * What cpurad_boot tells the application it starts. Written just before
+ * the jump; only append fields and bump BOOT_HANDOFF_VERSION on any other
+ * change.
+ */
+struct boot_handoff {
+	uint32_t magic;
+	uint16_t version;
+	/** sizeof(struct boot_handoff) of the writer */
+	uint16_t size;
+	/** enum boot_reason */
+	uint8_t reason;
+	/** enum boot_dfu_reason */
+	uint8_t dfu_reason;
+	/** Slot started, 0 for cpurad_app_partition */
+	uint8_t slot;
+	/** enum boot_verify */
+	uint8_t verify;
+	struct boot_handoff_version image;
+	/** CRC-32 of the boot timeline as it was at the jump */
+	uint32_t timeline_crc;
+	/** CRC-32 of the fields above */
+	uint32_t crc;
+};
+
+static inline uint32_t boot_handoff_crc(const struct boot_handoff *h)
+{
+	return crc32_ieee((const uint8_t *)h, offsetof(struct boot_handoff, crc));
+}
+
+#endif
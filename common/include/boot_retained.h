@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_BOOT_RETAINED_
+#define H_BOOT_RETAINED_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/toolchain.h>
+#include <boot_handoff.h>
+#include <boot_timeline.h>
+
+/**
+ * Layout of the retained RAM block shared between cpurad_boot and the
+ * application. The block is declared as cpurad_retained_ram in
+ * dts_common/nrf54h20_cpurad.dtsi and is not cleared by either image.
+ */
+struct boot_retained {
+	/** Set to BOOT_DFU_REQUEST_MAGIC by the application before a reset
+	 *  to make the bootloader stay in DFU mode.
+	 */
+	uint32_t dfu_request;
+	/** Per-stage cycle stamps recorded by the bootloader */
+	struct boot_timeline timeline;
+	/** Boot reason, slot and verification of the started image */
+	struct boot_handoff handoff;
+	/** Set to BOOT_CONFIRM_MAGIC by the application once the image it
+	 *  was started with works. The bootloader raises the rollback counter
+	 *  to that image on the next reset.
+	 */
+	uint32_t confirm;
+};
+
+#define BOOT_RETAINED_NODE      DT_NODELABEL(cpurad_retained_ram)
+#define BOOT_RETAINED_ADDR      DT_REG_ADDR(BOOT_RETAINED_NODE)
+#define BOOT_RETAINED_SIZE      DT_REG_SIZE(BOOT_RETAINED_NODE)
+
+#define BOOT_DFU_REQUEST_MAGIC  0x44465552 /* "DFUR" */
+#define BOOT_CONFIRM_MAGIC      0x4D464E43 /* "CNFM" */
+
+#define boot_retained ((volatile struct boot_retained *)BOOT_RETAINED_ADDR)
+
+BUILD_ASSERT(sizeof(struct boot_retained) <= BOOT_RETAINED_SIZE,
+	     "boot_retained does not fit in cpurad_retained_ram");
+
+/**
+ * Ask the bootloader to enter DFU mode on the next reset.
+ */
+static inline void boot_request_dfu(void)
+{
+	boot_retained->dfu_request = BOOT_DFU_REQUEST_MAGIC;
+}
+
+/**
+ * Confirm the running image. Only has an effect with
+ * CONFIG_RAD_BOOT_ROLLBACK in the bootloader: older images are refused
+ * from the next reset on.
+ */
+static inline void boot_confirm_image(void)
+{
+	boot_retained->confirm = BOOT_CONFIRM_MAGIC;
+}
+
+static inline void boot_retained_read(void *dst, const volatile void *src, size_t len)
+{
+	const volatile uint8_t *s = src;
+	uint8_t *d = dst;
+
+	for (size_t i = 0; i < len; i++) {
+		d[i] = s[i];
+	}
+}
+
+/**
+ * CRC-32 of the boot timeline in the retained block.
+ */
+static inline uint32_t boot_timeline_crc(void)
+{
+	struct boot_timeline tl;
+
+	boot_retained_read(&tl, &boot_retained->timeline, sizeof(tl));
+
+	return crc32_ieee((const uint8_t *)&tl, sizeof(tl));
+}
+
+/**
+ * Copy the handoff record out of the retained block.
+ *
+ * @return true if @p h holds a record of this version with a valid CRC
+ */
+static inline bool boot_handoff_load(struct boot_handoff *h)
+{
+	boot_retained_read(h, &boot_retained->handoff, sizeof(*h));
+
+	return h->magic == BOOT_HANDOFF_MAGIC &&
+	       h->version == BOOT_HANDOFF_VERSION &&
+	       h->size == sizeof(*h) &&
+	       h->crc == boot_handoff_crc(h);
+}
+
+#endif
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_BOOT_TIMELINE_
+#define H_BOOT_TIMELINE_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Boot stages recorded by cpurad_boot. The values are stored in
+ * boot_timeline.stage[] and are part of the layout shared with the
+ * application and scripts/boot_timeline.py: only append new stages.
+ */
+enum boot_tl_stage {
+	BOOT_TL_EARLY_INIT = 0,     /* PRE_KERNEL_1, cycle counter started */
+	BOOT_TL_MAIN,               /* bootloader main() entered */
+	BOOT_TL_DECISION,           /* DFU / fast boot decision made */
+	BOOT_TL_USB_INIT,           /* hsusb_init() returned */
+	BOOT_TL_DFU_DONE,           /* DFU session finished */
+	BOOT_TL_USB_SHUTDOWN,       /* USB stack shut down and reset */
+	BOOT_TL_PERIPH_CLEANUP,     /* nrf_cleanup_peripheral() returned */
+	BOOT_TL_NVIC_CLEANUP,       /* cleanup_arm_nvic() returned */
+	BOOT_TL_CACHE_FLUSH,        /* caches flushed and disabled */
+	BOOT_TL_JUMP,               /* about to branch to the reset vector */
+	BOOT_TL_APP_MAIN,           /* application main(), set by the app */
+	BOOT_TL_USB_DISCONNECT,     /* USB soft disconnect held */
+	BOOT_TL_USB_CORE_RESET,     /* USB core soft reset done or timed out */
+	BOOT_TL_STAGE1,             /* DFU stage-1 entered from stage-0 */
+	BOOT_TL_STAGE_COUNT,
+};
+
+#define BOOT_TIMELINE_MAGIC     0x4C544F42 /* "BOTL" */
+#define BOOT_TIMELINE_VERSION   2
+#define BOOT_TIMELINE_MAX       16
+
+/**
+ * Boot stages in the order they were marked. The cycle counter (DWT
+ * CYCCNT) is started from zero in cpurad_boot early init and wraps every
+ * 2^32 / cycles_per_sec seconds, 16.7 s at 256 MHz, well within a DFU
+ * session. The bootloader counts the wraps, so the stamps are microseconds
+ * since the counter started and keep growing.
+ */
+struct boot_timeline {
+	uint32_t magic;
+	uint16_t version;
+	/** Entries used in stage[] and stamp[] */
+	uint16_t count;
+	uint32_t cycles_per_sec;
+	/** Counter value when the wraps were last counted */
+	uint32_t sync_cycles;
+	/** Counter wraps before sync_cycles */
+	uint32_t wraps;
+	/** enum boot_tl_stage of each entry */
+	uint8_t stage[BOOT_TIMELINE_MAX];
+	/** Microseconds since the counter started, for each entry */
+	uint32_t stamp[BOOT_TIMELINE_MAX];
+};
+
+static inline bool boot_timeline_is_valid(const volatile struct boot_timeline *tl)
+{
+	return tl->magic == BOOT_TIMELINE_MAGIC &&
+	       tl->version == BOOT_TIMELINE_VERSION &&
+	       tl->count <= BOOT_TIMELINE_MAX;
+}
+
+/**
+ * Cycles since the counter started, for a counter value @p now read after
+ * the last update of @p tl. Counts a wrap if the counter went back, so
+ * @p tl must be updated at least once per wrap period.
+ */
+static inline uint64_t boot_timeline_sync(volatile struct boot_timeline *tl, uint32_t now)
+{
+	if (now < tl->sync_cycles) {
+		tl->wraps++;
+	}
+	tl->sync_cycles = now;
+
+	return ((uint64_t)tl->wraps << 32) | now;
+}
+
+/**
+ * Convert boot_timeline_sync() cycles to a stamp.
+ */
+static inline uint32_t boot_timeline_us(const volatile struct boot_timeline *tl,
+					uint64_t cycles)
+{
+	return (uint32_t)((cycles * 1000000U) / tl->cycles_per_sec);
+}
+
+/**
+ * Start an empty timeline at counter value zero.
+ */
+static inline void boot_timeline_reset(volatile struct boot_timeline *tl,
+				       uint32_t cycles_per_sec)
+{
+	tl->magic = 0;
+	for (int i = 0; i < BOOT_TIMELINE_MAX; i++) {
+		tl->stage[i] = 0;
+		tl->stamp[i] = 0;
+	}
+	tl->sync_cycles = 0;
+	tl->wraps = 0;
+	tl->version = BOOT_TIMELINE_VERSION;
+	tl->cycles_per_sec = cycles_per_sec;
+	tl->count = 0;
+	tl->magic = BOOT_TIMELINE_MAGIC;
+}
+
+/**
+ * Append @p stage, reached at counter value @p now, as the next entry.
+ * Entries beyond BOOT_TIMELINE_MAX are dropped.
+ */
+static inline void boot_timeline_append(volatile struct boot_timeline *tl,
+					uint8_t stage, uint32_t now)
+{
+	uint64_t cycles = boot_timeline_sync(tl, now);
+
+	if (tl->count < BOOT_TIMELINE_MAX) {
+		tl->stage[tl->count] = stage;
+		tl->stamp[tl->count] = boot_timeline_us(tl, cycles);
+		tl->count++;
+	}
+}
+
+#endif
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_HID_STATS_
+#define H_HID_STATS_
+
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/toolchain.h>
+#include <zephyr/sys/util.h>
+#include <zephyr/usb/class/hid.h>
+
+/*
+ * Input statistics served as a vendor feature report by the HID mouse of
+ * hid_mouse and cpurad_boot, read by scripts/hid_stats.py. The report ID
+ * is free in both report descriptors. Only append fields and bump
+ * HID_STATS_VERSION on any other change.
+ */
+
+#define HID_STATS_REPORT_ID     5
+#define HID_STATS_VERSION       1
+#define HID_STATS_HIST_BUCKETS  16
+/* Bucket 0 counts latencies below 2^HID_STATS_HIST_SHIFT cycles */
+#define HID_STATS_HIST_SHIFT    10
+
+/**
+ * Report payload, little-endian. Latencies and ISR times are DWT cycles,
+ * cycles_per_sec converts them.
+ */
+struct hid_stats {
+	uint8_t version;
+	uint8_t hist_shift;
+	uint16_t hist_buckets;
+	uint32_t cycles_per_sec;
+	/** Input events queued from the buttons */
+	uint32_t events;
+	/** Reports queued to the interrupt IN endpoint */
+	uint32_t sent;
+	/** Events folded into a report together with an earlier one */
+	uint32_t merged;
+	/** Events whose button state was lost, their motion was kept */
+	uint32_t dropped;
+	/** Reports the HID class did not accept */
+	uint32_t submit_err;
+	/** HID interface ready / not ready transitions */
+	uint32_t ready_up;
+	uint32_t ready_down;
+	uint32_t isr_count;
+	uint32_t isr_cycles_max;
+	uint64_t isr_cycles_sum;
+	/**
+	 * GPIO interrupt to report submit. Bucket i > 0 counts latencies
+	 * from 2^(hist_shift + i - 1) up to 2^(hist_shift + i) cycles, the
+	 * last bucket everything above.
+	 */
+	uint32_t hist[HID_STATS_HIST_BUCKETS];
+} __packed;
+
+/* Vendor collection with the statistics feature report. Usage page
+ * 0xFF01 keeps it apart from the 0xFF00 collections the DFU and timeline
+ * tools look for.
+ */
+#define HID_STATS_REPORT_DESC()							\
+	HID_ITEM(HID_ITEM_TAG_USAGE_PAGE, HID_ITEM_TYPE_GLOBAL, 2), 0x01, 0xFF,	\
+	HID_USAGE(0x01),							\
+	HID_COLLECTION(HID_COLLECTION_APPLICATION),				\
+		HID_REPORT_ID(HID_STATS_REPORT_ID),				\
+		HID_USAGE(0x02),						\
+		HID_LOGICAL_MIN8(0),						\
+		HID_LOGICAL_MAX16(0xFF, 0x00),					\
+		HID_REPORT_SIZE(8),						\
+		HID_REPORT_COUNT(sizeof(struct hid_stats)),			\
+		HID_FEATURE(0x02),						\
+	HID_END_COLLECTION
+
+BUILD_ASSERT(sizeof(struct hid_stats) <= UINT8_MAX, "hid_stats exceeds the report count item");
+
+static inline void hid_stats_init(struct hid_stats *st, uint32_t cycles_per_sec)
+{
+	memset(st, 0, sizeof(*st));
+	st->version = HID_STATS_VERSION;
+	st->hist_shift = HID_STATS_HIST_SHIFT;
+	st->hist_buckets = HID_STATS_HIST_BUCKETS;
+	st->cycles_per_sec = cycles_per_sec;
+}
+
+static inline void hid_stats_latency(struct hid_stats *st, uint32_t cycles)
+{
+	int idx = 0;
+
+	if (cycles >= BIT(HID_STATS_HIST_SHIFT)) {
+		/* Bit length of cycles, minus the shift */
+		idx = MIN(32 - __builtin_clz(cycles) - HID_STATS_HIST_SHIFT,
+			  HID_STATS_HIST_BUCKETS - 1);
+	}
+
+	st->hist[idx]++;
+}
+
+static inline void hid_stats_isr(struct hid_stats *st, uint32_t cycles)
+{
+	st->isr_count++;
+	st->isr_cycles_max = MAX(st->isr_cycles_max, cycles);
+	st->isr_cycles_sum += cycles;
+}
+
+/**
+ * Fill the HID_STATS_REPORT_ID feature report.
+ *
+ * @return Report length including the report ID, 0 if @p len is too short
+ */
+static inline int hid_stats_report(const struct hid_stats *st, uint8_t *buf, uint16_t len)
+{
+	if (len < 1 + sizeof(*st)) {
+		return 0;
+	}
+
+	buf[0] = HID_STATS_REPORT_ID;
+	memcpy(&buf[1], st, sizeof(*st));
+
+	return 1 + sizeof(*st);
+}
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_DELTA_
+#define H_DELTA_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/toolchain.h>
+#include <image.h>
+
+/*
+ * A delta patch rebuilds the contents of a slot from the image in the
+ * other slot. It is a delta_hdr followed by delta_op records; a
+ * DELTA_OP_INSERT record is followed by len literal bytes. Ops produce the
+ * output in order, so the patch is applied while it streams in. Patches
+ * are generated by scripts/rad_delta.py. All fields are little endian.
+ */
+
+#define DELTA_MAGIC             0x544C4452 /* "RDLT" */
+
+struct delta_hdr {
+	uint32_t magic;
+	/* Header plus image bytes of the source image */
+	uint32_t src_size;
+	/* Bytes produced by the patch */
+	uint32_t out_size;
+	/* SHA-256 from the source image header */
+	uint8_t src_sha256[IMAGE_HASH_SIZE];
+} __packed;
+
+enum delta_op_type {
+	/* len bytes from src_off of the source slot */
+	DELTA_OP_COPY = 1,
+	/* len bytes following the op */
+	DELTA_OP_INSERT = 2,
+};
+
+struct delta_op {
+	uint8_t op;
+	uint8_t reserved[3];
+	uint32_t len;
+	uint32_t src_off;
+} __packed;
+
+/**
+ * Receives patch output in order. @p data has room to be padded up to
+ * the flash write block size. Every call but the last one passes a
+ * multiple of CONFIG_RAD_BOOT_DELTA_WINDOW_SIZE bytes.
+ */
+typedef int (*delta_emit_t)(uint32_t off, uint8_t *data, size_t len);
+
+/**
+ * Start applying a patch against the image in @p src.
+ *
+ * @param src Slot holding the source image
+ * @param max_out Size of the destination
+ * @param emit Called with every window of output
+ *
+ * @retval 0 on success, -errno if @p src cannot be opened
+ */
+int delta_begin(enum image_slot src, size_t max_out, delta_emit_t emit);
+
+/**
+ * Apply the next @p len bytes of the patch. Output is buffered in a
+ * CONFIG_RAD_BOOT_DELTA_WINDOW_SIZE window and emitted whenever it fills.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL on a malformed patch or an op outside the source
+ * @retval -ESTALE if the patch was made for another source image
+ * @retval -EFBIG if the output does not fit in @p max_out
+ * @retval -errno from the source read or from emit
+ */
+int delta_feed(const uint8_t *data, size_t len);
+
+/**
+ * Emit the rest of the window once the whole patch was fed.
+ *
+ * @param out_size Set to the number of bytes produced
+ *
+ * @retval 0 on success
+ * @retval -ENODATA if the patch is incomplete
+ */
+int delta_finish(size_t *out_size);
+
+#endif
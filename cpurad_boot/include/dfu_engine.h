@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_DFU_ENGINE_
+#define H_DFU_ENGINE_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/kernel.h>
+#include <image.h>
+
+#define DFU_DIGEST_SIZE         32
+
+/**
+ * One chunk of image data on its way to the target slot.
+ *
+ * The engine writes chunks from its own thread, so the producer can receive
+ * the next chunk into another buffer while this one is programmed. @p data
+ * must stay valid until @p done is called and must have room to be padded
+ * up to the flash write block size.
+ */
+struct dfu_chunk {
+	void *fifo_reserved;
+	uint32_t offset;
+	uint8_t *data;
+	size_t len;
+	void (*done)(struct dfu_chunk *chunk, int err);
+	void *user_data;
+};
+
+enum dfu_notify {
+	DFU_NOTIFY_ACTIVITY,    /* a packet was handled */
+	DFU_NOTIFY_DONE,        /* complete image written */
+	DFU_NOTIFY_ERROR,       /* session failed */
+};
+
+typedef void (*dfu_notify_t)(enum dfu_notify evt);
+
+enum dfu_format {
+	DFU_FORMAT_RAW,         /* slot contents */
+	DFU_FORMAT_DELTA,       /* patch against the other slot, see delta.h */
+	DFU_FORMAT_LZ4,         /* compressed slot contents, see unlz4.h */
+};
+
+struct dfu_engine_stats {
+	uint32_t bytes;
+	uint32_t chunks;
+	/** Cycles spent programming MRAM */
+	uint32_t write_cycles;
+	/** Cycles spent in SHA-256 */
+	uint32_t hash_cycles;
+	/** Cycles from begin to the last chunk written */
+	uint32_t total_cycles;
+	/** MRAM write units programmed, set by dfu_engine_end() */
+	uint32_t blocks_written;
+	/** MRAM write units that already held the data */
+	uint32_t blocks_skipped;
+};
+
+/**
+ * Register the callback informed about session progress.
+ */
+void dfu_engine_init(dfu_notify_t notify);
+
+/**
+ * Select the slot the next session writes to, IMAGE_SLOT_SECONDARY by
+ * default. Must not be called while a session is running.
+ */
+void dfu_engine_set_slot(enum image_slot slot);
+
+/**
+ * Slot the next session writes to.
+ */
+enum image_slot dfu_engine_slot(void);
+
+/**
+ * Forward a session event to the registered callback. The transport
+ * reports DFU_NOTIFY_DONE once the host has seen the final status.
+ */
+void dfu_engine_notify(enum dfu_notify evt);
+
+/**
+ * Start receiving @p size bytes in @p format.
+ *
+ * Every chunk is fed into a SHA-256 as it is written, so the digest is
+ * ready when the last chunk lands and dfu_engine_end() can accept or
+ * reject the image without reading the partition back.
+ *
+ * Delta patches and LZ4 streams are decoded while they stream in, so their
+ * chunks must arrive in order. The SHA-256 is computed over the decoded
+ * output: @p digest is always the digest of the image written to the slot.
+ *
+ * With CONFIG_RAD_BOOT_DFU_RESUME, a raw session with a digest picks up
+ * the chunks a previous session for the same image already wrote.
+ *
+ * @param size Bytes the host sends
+ * @param digest Expected SHA-256 of the image, NULL to skip the comparison
+ * @param format Encoding of the data
+ *
+ * @retval 0 on success
+ * @retval -EFBIG if the data does not fit in the partition
+ * @retval -EBUSY if chunks of a previous session are still pending
+ * @retval -ENOTSUP if @p format is not enabled
+ */
+int dfu_engine_begin(size_t size, const uint8_t *digest, enum dfu_format format);
+
+/**
+ * Queue a chunk for writing. Never blocks.
+ *
+ * @retval 0 on success, @p chunk->done is called once written
+ * @retval -EINVAL if the chunk is misaligned or outside the image
+ * @retval -EIO if the session already failed
+ */
+int dfu_engine_submit(struct dfu_chunk *chunk);
+
+/**
+ * Wait for all queued chunks and close the session.
+ * Reports DFU_NOTIFY_ERROR on failure.
+ *
+ * @retval 0 if the full image was written and matches the digest
+ * @retval -ENODATA if bytes are missing or a patch is incomplete; a
+ *         resumable session is kept so the missing chunks can follow
+ * @retval -ESTALE if a patch was made for another source image
+ * @retval -EBADMSG if the digest does not match, or the first write error
+ * @retval -ENOEXEC if the image is not linked for image_load_addr() of
+ *         the target slot
+ */
+int dfu_engine_end(k_timeout_t timeout);
+
+/**
+ * Drop the current session.
+ */
+void dfu_engine_abort(void);
+
+/**
+ * Chunks already written for the current session, see dfu_state.h.
+ *
+ * @param len Set to the number of valid bytes
+ *
+ * @retval NULL if the session is not resumable
+ */
+const uint8_t *dfu_engine_resume_map(size_t *len);
+
+/**
+ * Flash write block size, chunk offsets must be aligned to it.
+ */
+size_t dfu_engine_write_align(void);
+
+void dfu_engine_stats_get(struct dfu_engine_stats *stats);
+
+/**
+ * SHA-256 of the last image accepted by dfu_engine_end().
+ */
+const uint8_t *dfu_engine_digest(void);
+
+#if defined(CONFIG_RAD_BOOT_DFU_BENCH)
+/**
+ * Stream a synthetic image the size of the target slot through the
+ * engine and print the throughput. Overwrites the slot.
+ */
+void dfu_bench_run(void);
+#endif
+
+#endif
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_DFU_HID_
+#define H_DFU_HID_
+
+#include <stdint.h>
+
+/*
+ * DFU transport over the bootloader's HID interface, see dfu_proto.h.
+ * The HID device callbacks in main.c hand the DFU reports over.
+ */
+
+/**
+ * Handle a DFU_HID_DATA_REPORT_ID output report, @p buf starts with the
+ * report ID. May block while all chunk buffers are being written.
+ */
+void dfu_hid_output(const uint8_t *buf, uint16_t len);
+
+/**
+ * Fill the DFU_HID_STATUS_REPORT_ID feature report.
+ *
+ * @return Report length including the report ID, 0 if @p len is too short
+ */
+int dfu_hid_status_get(uint8_t *buf, uint16_t len);
+
+/**
+ * Drop the current session when the interface goes down.
+ */
+void dfu_hid_disable(void);
+
+#endif
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_DFU_PROTO_
+#define H_DFU_PROTO_
+
+#include <stdint.h>
+#include <zephyr/sys/util_macro.h>
+#include <zephyr/toolchain.h>
+
+/*
+ * DFU packets exchanged with the host over the vendor bulk interface.
+ *
+ * Every OUT transfer carries one packet: a dfu_pkt_hdr followed by len
+ * payload bytes. The device answers every packet with a dfu_pkt_rsp on the
+ * IN endpoint once it has been handled; for DFU_CMD_DATA that is after the
+ * chunk has been written to MRAM. The host may keep up to the number of
+ * buffers reported in the DFU_CMD_BEGIN response in flight.
+ *
+ * The offset of the DFU_CMD_BEGIN response is the address the image has to
+ * be linked for. With A/B execute in place this is the slot the device is
+ * not running from, so the host picks the matching build.
+ */
+
+enum dfu_cmd {
+	/* offset: image size, payload: SHA-256 of the image.
+	 * With DFU_FLAG_DELTA or DFU_FLAG_LZ4, offset is the size of the
+	 * patch or compressed stream carried by DATA; the SHA-256 is still
+	 * that of the decoded image.
+	 */
+	DFU_CMD_BEGIN = 1,
+	/* offset: image offset, payload: image data */
+	DFU_CMD_DATA = 2,
+	/* wait for all data to be written, status EBADMSG on digest mismatch */
+	DFU_CMD_END = 3,
+	DFU_CMD_ABORT = 4,
+	/* response offset: chunk size, response payload: one bit per chunk of
+	 * the current session, set once the chunk is written. After a BEGIN
+	 * that resumed an interrupted session only the clear bits need DATA.
+	 * Status ENODATA if the session cannot be resumed.
+	 */
+	DFU_CMD_QUERY = 5,
+};
+
+/* dfu_pkt_hdr flags */
+#define DFU_FLAG_DELTA          BIT(0)
+#define DFU_FLAG_LZ4            BIT(1)
+
+struct dfu_pkt_hdr {
+	uint8_t cmd;
+	uint8_t flags;
+	uint16_t len;
+	uint32_t offset;
+} __packed;
+
+/* Followed by payload bytes for DFU_CMD_QUERY only */
+struct dfu_pkt_rsp {
+	uint8_t cmd;
+	/* 0 or a positive errno value */
+	uint8_t status;
+	/* DFU_CMD_BEGIN: buffers the host may keep in flight */
+	uint8_t window;
+	uint8_t reserved;
+	uint32_t offset;
+} __packed;
+
+/*
+ * The same packets over the bootloader's HID interface, for hosts that
+ * cannot bind a driver to the vendor bulk interface.
+ *
+ * Every DFU_HID_DATA_REPORT_ID output report carries one packet, a
+ * dfu_pkt_hdr and up to DFU_HID_DATA_SIZE - sizeof(struct dfu_pkt_hdr)
+ * payload bytes; the rest of the report is padding. DATA packets of a chunk
+ * must follow each other in order. The host keeps writing reports, the
+ * device stops accepting them while all CONFIG_RAD_BOOT_DFU_BUF_COUNT
+ * chunk buffers are being written.
+ *
+ * Output reports are not answered. The DFU_HID_STATUS_REPORT_ID feature
+ * report returns a dfu_hid_status instead.
+ */
+#define DFU_HID_DATA_REPORT_ID    3
+#define DFU_HID_STATUS_REPORT_ID  4
+
+/* Output report size without the report ID */
+#define DFU_HID_DATA_SIZE         1023
+#define DFU_HID_MAP_SIZE          240
+
+struct dfu_hid_status {
+	/* Response to the last packet other than DATA */
+	struct dfu_pkt_rsp rsp;
+	/* DATA bytes written since BEGIN */
+	uint32_t written;
+	/* First DATA failure, 0 or a positive errno value */
+	uint8_t data_status;
+	uint8_t reserved;
+	/* DFU_CMD_QUERY: valid bytes of map */
+	uint16_t map_len;
+	uint8_t map[DFU_HID_MAP_SIZE];
+} __packed;
+
+#define DFU_USB_CLASS           0xFF
+#define DFU_USB_SUBCLASS        0x44 /* 'D' */
+#define DFU_USB_PROTOCOL        0x01
+
+#endif
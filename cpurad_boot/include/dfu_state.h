@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_DFU_STATE_
+#define H_DFU_STATE_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <image.h>
+
+/*
+ * Progress of a raw DFU session, kept in boot_dfu_state_partition: the
+ * image size, target slot and SHA-256 announced by BEGIN plus one bit per
+ * CONFIG_RAD_BOOT_DFU_CHUNK_SIZE chunk that has been written. A later
+ * BEGIN for the same image picks the session up again and the host only
+ * sends the chunks that are missing.
+ *
+ * The bitmap is an optimization only. A bit lost to a reset costs a
+ * retransmission, and whatever the bitmap claims, the image is accepted
+ * only if it matches the announced SHA-256.
+ */
+
+/**
+ * Pick up the session for this image if there is one, otherwise start a
+ * new one with no chunk written.
+ *
+ * @retval true if a previous session was resumed
+ */
+bool dfu_state_begin(enum image_slot slot, uint32_t size, const uint8_t *digest);
+
+/**
+ * Record that the chunk at @p offset has been written.
+ */
+void dfu_state_mark(uint32_t offset);
+
+/**
+ * Chunks of the current session not written yet.
+ */
+uint32_t dfu_state_missing(void);
+
+/**
+ * Bitmap of the current session, bit n set once chunk n is written.
+ *
+ * @param len Set to the number of valid bytes
+ */
+const uint8_t *dfu_state_bitmap(size_t *len);
+
+/**
+ * Forget the session once the image was accepted or rejected.
+ */
+void dfu_state_clear(void);
+
+#ifdef CONFIG_ZTEST
+/**
+ * Test only: lose the RAM copy of the session, as a reset does.
+ */
+void dfu_state_test_reset(void);
+#endif
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_HANDOFF_
+#define H_HANDOFF_
+
+#include <stdbool.h>
+#include <boot_handoff.h>
+#include <image.h>
+
+/**
+ * Take the record left by the previous boot out of retained RAM. Must run
+ * before handoff_prepare() and before anything writes the record.
+ */
+void handoff_init(void);
+
+/**
+ * Record the previous boot left, NULL if there was none or it did not
+ * pass its checks.
+ */
+const struct boot_handoff *handoff_previous(void);
+
+/**
+ * Fill in the record for the application about to be started from
+ * @p slot. The boot reason is judged against the previous record.
+ *
+ * @param slot Slot that is started, already validated
+ * @param dfu_reason Why DFU mode was entered, BOOT_DFU_NONE if it was not
+ * @param installed true if an image was received or swapped in on this boot
+ */
+void handoff_prepare(enum image_slot slot, enum boot_dfu_reason dfu_reason, bool installed);
+
+/**
+ * Bind the record to the final boot timeline and write it to retained RAM.
+ * Does nothing unless handoff_prepare() was called, so stage-0 leaves the
+ * previous record to stage-1. Safe to call with caches disabled.
+ */
+void handoff_seal(void);
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_IMAGE_
+#define H_IMAGE_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <zephyr/toolchain.h>
+#include <boot_handoff.h>
+
+/*
+ * Every application image starts with an image_header, written by
+ * scripts/rad_image.py. The application is linked with
+ * CONFIG_ROM_START_OFFSET equal to hdr_size so its vector table follows
+ * the header.
+ */
+
+#define IMAGE_MAGIC             0x49444152 /* "RADI" */
+#define IMAGE_HASH_SIZE         32
+
+/* image_header.flags: the header is followed by an ECDSA P-256 signature
+ * over it, raw r || s
+ */
+#define IMAGE_F_SIGNED          0x0001
+#define IMAGE_SIG_SIZE          64
+
+struct image_version {
+	uint8_t major;
+	uint8_t minor;
+	uint16_t revision;
+	uint32_t build;
+} __packed;
+
+struct image_header {
+	uint32_t magic;
+	/* Offset of the vector table from the start of the slot */
+	uint16_t hdr_size;
+	uint16_t flags;
+	/* Bytes following the header */
+	uint32_t img_size;
+	/* Address of the slot the image is linked to run from */
+	uint32_t load_addr;
+	struct image_version version;
+	/* SHA-256 over the img_size bytes following the header */
+	uint8_t sha256[IMAGE_HASH_SIZE];
+} __packed;
+
+enum image_slot {
+	IMAGE_SLOT_PRIMARY = 0,     /* cpurad_app_partition */
+	IMAGE_SLOT_SECONDARY,       /* cpurad_app2_partition */
+	IMAGE_SLOT_COUNT,
+};
+
+/**
+ * Memory mapped address of a slot.
+ */
+uint32_t image_slot_addr(enum image_slot slot);
+
+/**
+ * Size of a slot in bytes.
+ */
+uint32_t image_slot_size(enum image_slot slot);
+
+/**
+ * Flash map partition ID of a slot.
+ */
+uint8_t image_slot_fa_id(enum image_slot slot);
+
+/**
+ * Address an image written to @p slot has to be linked for: the slot
+ * itself with CONFIG_RAD_BOOT_XIP_AB, the primary slot otherwise.
+ */
+uint32_t image_load_addr(enum image_slot slot);
+
+/**
+ * Compare two image versions.
+ *
+ * @return <0, 0 or >0 if @p a is older than, equal to or newer than @p b
+ */
+int image_version_cmp(const struct image_version *a, const struct image_version *b);
+
+/**
+ * Header of the image in @p slot, NULL if the slot holds no well formed
+ * header.
+ */
+const struct image_header *image_header_get(enum image_slot slot);
+
+/**
+ * Address of the vector table of the image in @p slot.
+ */
+uint32_t image_entry(enum image_slot slot);
+
+/**
+ * Check the image in @p slot against the SHA-256 in its header.
+ *
+ * A record of the last result is kept in boot_cache_partition. While the
+ * header still hashes to the recorded value, the result is taken from the
+ * record and the image itself is not read.
+ *
+ * The image must also be linked for image_load_addr() of @p slot. With
+ * CONFIG_RAD_BOOT_SIGNATURE the header must carry a valid signature by
+ * CONFIG_RAD_BOOT_SIGNATURE_KEY as well.
+ *
+ * @retval 0 if the image is valid
+ * @retval -ENOENT if there is no image header
+ * @retval -ENOEXEC if the image is linked for another slot
+ * @retval -EBADMSG if the image does not match its digest
+ * @retval -EPERM if the signature is missing or does not verify
+ */
+int image_validate(enum image_slot slot);
+
+/**
+ * How the last image_validate() of @p slot found the image valid,
+ * BOOT_VERIFY_NONE if it did not.
+ */
+enum boot_verify image_verified_by(enum image_slot slot);
+
+/**
+ * Forget the cached result for @p slot. Must be called before the slot
+ * is written.
+ */
+void image_cache_invalidate(enum image_slot slot);
+
+/**
+ * Check the USB DFU stage-1 in cpurad_stage1_partition before stage-0
+ * starts it: header, load address, digest and, with
+ * CONFIG_RAD_BOOT_SIGNATURE, signature, as for image_validate(). The
+ * result is not cached.
+ *
+ * @return 0 if stage-1 may be started, an image_validate() error otherwise
+ */
+int image_validate_stage1(void);
+
+/**
+ * Address of the stage-1 vector table. Only valid after
+ * image_validate_stage1() returned 0.
+ */
+uint32_t image_stage1_entry(void);
+
+#ifdef CONFIG_ZTEST
+/**
+ * Test only: map MRAM at @p mram, for instance the flash simulator memory,
+ * so that the slots can be validated in place.
+ */
+void image_test_map(const void *mram);
+#endif
+
+#endif
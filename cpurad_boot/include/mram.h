@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_MRAM_
+#define H_MRAM_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <zephyr/storage/flash_map.h>
+
+/*
+ * Write layer used for every flash write of the bootloader.
+ *
+ * MRAM needs no erase, so a block that already holds the new data does not
+ * have to be programmed at all. With CONFIG_RAD_BOOT_MRAM_COMPARE each write
+ * unit (the partition's write block size) is read first and only runs of
+ * differing units are programmed, each run with a single write. Writes that
+ * do not cover whole units are merged with the current content, so the
+ * flash driver only ever sees full, aligned units.
+ */
+
+struct mram_stats {
+	/** Write units programmed */
+	uint32_t blocks_written;
+	/** Write units that already held the data */
+	uint32_t blocks_skipped;
+};
+
+/**
+ * Write @p len bytes at @p off of @p fa. Any alignment is accepted.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL if the write block size of @p fa is not supported
+ * @retval -errno from the flash driver
+ */
+int mram_write(const struct flash_area *fa, off_t off, const void *data, size_t len);
+
+/**
+ * Counters since boot, for callers to take differences of.
+ */
+void mram_stats_get(struct mram_stats *stats);
+
+#endif
@@ -7,15 +7,71 @@
 #ifndef H_NRF_CLEANUP_
 #define H_NRF_CLEANUP_
 
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * One peripheral instance reset before the application is started.
+ *
+ * nrf_cleanup_peripheral() runs a table of these generated from the
+ * devicetree of the bootloader build, so only instances enabled there are
+ * touched. Reset routines access registers through @p base only and can
+ * be run against a register file in RAM.
+ */
+struct nrf_cleanup_entry {
+	uintptr_t base;
+	/* GPIO ports: pins to reset */
+	uint32_t pins;
+	/* NULL to leave the instance as it is */
+	void (*reset)(const struct nrf_cleanup_entry *entry);
+};
+
+void nrf_cleanup_rtc(const struct nrf_cleanup_entry *entry);
+void nrf_cleanup_uarte(const struct nrf_cleanup_entry *entry);
+void nrf_cleanup_dppic(const struct nrf_cleanup_entry *entry);
+void nrf_cleanup_gpio_port(const struct nrf_cleanup_entry *entry);
+
+/**
+ * Call the reset routine of every entry in @p table.
+ */
+void nrf_cleanup_table_run(const struct nrf_cleanup_entry *table, size_t count);
+
 /**
  * Perform cleanup on some peripheral resources used by MCUBoot prior chainload
  * the application.
  *
- * This function disables all RTC instances and UARTE instances.
- * It Disables their interrupts signals as well.
+ * This function resets the RTC, UARTE, local DPPIC and GPIO instances
+ * enabled in the devicetree, except the console UARTE. It disables their
+ * interrupt signals as well. On a GPIO port only the pins named in the
+ * gpios property of an enabled node are reset.
  */
 void nrf_cleanup_peripheral(void);
 
+/**
+ * Soft-disconnect and reset the DWC2 core whose registers start at
+ * @p base, as nrf_cleanup_usb() does for the USBHS controller.
+ *
+ * @retval 0 on success
+ * @retval -ETIMEDOUT if the core reset did not complete
+ */
+int nrf_cleanup_usb_core(uintptr_t base);
+
+#if defined(CONFIG_USB_DEVICE_STACK_NEXT)
+/**
+ * Soft-disconnect and reset the USBHS controller.
+ *
+ * Only needed when the bootloader has brought USB up; on the fast boot
+ * path the controller is never touched and this must not be called.
+ * Every wait is bounded in microseconds on the cycle counter, the end of
+ * each step is stamped in the boot timeline.
+ *
+ * @retval 0 on success
+ * @retval -ETIMEDOUT if the core reset did not complete, already reported
+ *         on the console
+ */
+int nrf_cleanup_usb(void);
+#endif
+
 /**
  * Perform cleanup of non-secure RAM that may have been used by MCUBoot.
  */
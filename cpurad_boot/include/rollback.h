@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_ROLLBACK_
+#define H_ROLLBACK_
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <image.h>
+
+/*
+ * Monotonic security counter kept in boot_counter_partition. Every update
+ * appends a CRC-protected record to a ring that spans the partition, so
+ * each MRAM write unit is programmed once per pass over the ring and the
+ * newest record is never overwritten. A write torn by a reset leaves a
+ * record that fails its CRC, and the previous value stays current.
+ *
+ * The partition is scanned on first use; after that the value and the
+ * position of the newest record are served from RAM.
+ */
+
+#define ROLLBACK_MAGIC          0x544E4352 /* "RCNT" */
+
+/** One MRAM write unit of the ring, crc is CRC-32 of the fields before it */
+struct rollback_rec {
+	uint32_t magic;
+	uint32_t seq;
+	uint32_t value;
+	uint32_t crc;
+};
+
+/**
+ * Counter value an image version maps to: major, minor and revision, the
+ * build number is ignored.
+ */
+uint32_t rollback_image_value(const struct image_version *version);
+
+/**
+ * Current counter value, 0 if none was ever written.
+ *
+ * @retval 0 on success
+ * @retval -errno if the partition cannot be read
+ */
+int rollback_counter_get(uint32_t *value);
+
+/**
+ * Raise the counter to @p value. Values not above the current one are
+ * ignored without a write.
+ *
+ * @retval 0 on success
+ * @retval -errno if the partition cannot be read or written
+ */
+int rollback_counter_set(uint32_t value);
+
+/**
+ * Check an image version against the counter. If the counter cannot be
+ * read the image is refused.
+ */
+bool rollback_allows(const struct image_version *version);
+
+#ifdef CONFIG_ZTEST
+/**
+ * Test only: lose the RAM copy of the counter, as a reset does.
+ */
+void rollback_test_reset(void);
+
+/**
+ * Test only: index of the newest record in the ring.
+ */
+uint32_t rollback_test_head(void);
+#endif
+
+#endif
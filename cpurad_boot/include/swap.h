@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_SWAP_
+#define H_SWAP_
+
+/*
+ * Swap the images in cpurad_app_partition and cpurad_app2_partition chunk
+ * by chunk through boot_scratch_partition. Each chunk takes three copies
+ * (primary to scratch, secondary to primary, scratch to secondary) and
+ * every completed copy is recorded in boot_journal_partition before the
+ * next one starts. All three copies are idempotent, so after a reset the
+ * swap repeats at most the copy that was interrupted.
+ */
+
+/**
+ * Finish an interrupted swap, or start one if cpurad_app2_partition holds
+ * a valid image newer than the one in cpurad_app_partition.
+ *
+ * @retval 0 if the slots were swapped
+ * @retval -EALREADY if there was nothing to install
+ * @retval -errno on flash errors, the journal is left for the next reset
+ */
+int swap_install(void);
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_TIMELINE_
+#define H_TIMELINE_
+
+#include <boot_timeline.h>
+
+/**
+ * Append a boot stage with the current time to the retained boot timeline.
+ * Safe to call with interrupts, timers and caches disabled.
+ */
+void timeline_mark(enum boot_tl_stage stage);
+
+/**
+ * Cycles elapsed since the timeline was started.
+ */
+uint32_t timeline_now(void);
+
+/**
+ * Convert a timeline_now() difference to microseconds.
+ */
+uint32_t timeline_cyc_to_us(uint32_t cycles);
+
+/**
+ * Convert microseconds to timeline_now() cycles.
+ */
+uint32_t timeline_us_to_cyc(uint32_t us);
+
+/**
+ * Poll @p reg until (value & @p mask) == @p expect, for at most
+ * @p timeout_us. Runs on the cycle counter, so it is safe with interrupts,
+ * timers and caches disabled.
+ *
+ * @param waited_us Set to the time spent polling
+ *
+ * @retval 0 if the register reached the expected value
+ * @retval -ETIMEDOUT otherwise
+ */
+int timeline_poll(const volatile uint32_t *reg, uint32_t mask, uint32_t expect,
+		  uint32_t timeout_us, uint32_t *waited_us);
+
+/**
+ * Busy wait for @p us on the cycle counter.
+ */
+void timeline_delay_us(uint32_t us);
+
+/**
+ * Print the duration of every stage recorded so far, in marking order.
+ */
+void timeline_log(void);
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_UNLZ4_
+#define H_UNLZ4_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <zephyr/toolchain.h>
+#include <zephyr/storage/flash_map.h>
+
+/*
+ * A compressed image is an unlz4_hdr followed by a single LZ4 block
+ * (https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md) holding
+ * the slot contents. Streams are produced by scripts/rad_lz4.py.
+ *
+ * The decoder keeps only a CONFIG_RAD_BOOT_LZ4_WINDOW_SIZE window of output
+ * in RAM. Matches reaching further back are read from the partition the
+ * output has already been written to, so the full 64KB LZ4 history is
+ * available without holding it in RAM.
+ */
+
+#define UNLZ4_MAGIC             0x345A4C52 /* "RLZ4" */
+
+struct unlz4_hdr {
+	uint32_t magic;
+	/* Bytes produced by the block */
+	uint32_t out_size;
+} __packed;
+
+/**
+ * Receives decoded output in order, as delta_emit_t.
+ */
+typedef int (*unlz4_emit_t)(uint32_t off, uint8_t *data, size_t len);
+
+/**
+ * Start decoding a stream.
+ *
+ * @param out Partition @p emit writes to, read back for long matches
+ * @param max_out Size of @p out
+ * @param emit Called with every window of output
+ */
+void unlz4_begin(const struct flash_area *out, size_t max_out, unlz4_emit_t emit);
+
+/**
+ * Decode the next @p len bytes of the stream.
+ *
+ * @retval 0 on success
+ * @retval -EINVAL on a malformed stream
+ * @retval -EFBIG if the output does not fit in @p max_out
+ * @retval -errno from the read back or from emit
+ */
+int unlz4_feed(const uint8_t *data, size_t len);
+
+/**
+ * Emit the rest of the window once the whole stream was fed.
+ *
+ * @param out_size Set to the number of bytes produced
+ *
+ * @retval 0 on success
+ * @retval -ENODATA if the stream is incomplete
+ */
+int unlz4_finish(size_t *out_size);
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+#include <delta.h>
+
+LOG_MODULE_REGISTER(delta, LOG_LEVEL_INF);
+
+#define DELTA_WINDOW_SIZE       CONFIG_RAD_BOOT_DELTA_WINDOW_SIZE
+
+BUILD_ASSERT(DELTA_WINDOW_SIZE % 16 == 0,
+	     "CONFIG_RAD_BOOT_DELTA_WINDOW_SIZE must be a multiple of the MRAM write block");
+
+enum delta_state {
+	DELTA_STATE_HDR,            /* assembling delta_hdr */
+	DELTA_STATE_OP,             /* assembling the next delta_op */
+	DELTA_STATE_INSERT,         /* literal bytes of an insert op */
+};
+
+static const struct flash_area *delta_src_fa;
+static enum image_slot delta_src;
+static delta_emit_t delta_emit;
+static size_t delta_max_out;
+
+static enum delta_state delta_state;
+static uint8_t delta_stage[MAX(sizeof(struct delta_hdr), sizeof(struct delta_op))];
+static size_t delta_stage_len;
+static struct delta_hdr delta_hdr;
+static uint32_t delta_insert_left;
+/* Output accounted to ops so far, including the window */
+static uint32_t delta_produced;
+
+/* Output not yet emitted, starting at delta_out_off */
+static uint8_t delta_win[DELTA_WINDOW_SIZE] __aligned(4);
+static size_t delta_win_len;
+static uint32_t delta_out_off;
+
+static int delta_flush(void)
+{
+	int err;
+
+	if (delta_win_len == 0) {
+		return 0;
+	}
+
+	err = delta_emit(delta_out_off, delta_win, delta_win_len);
+	delta_out_off += delta_win_len;
+	delta_win_len = 0;
+
+	return err;
+}
+
+static int delta_out(const uint8_t *data, size_t len)
+{
+	int err = 0;
+
+	while (len > 0 && err == 0) {
+		size_t n = MIN(len, sizeof(delta_win) - delta_win_len);
+
+		memcpy(&delta_win[delta_win_len], data, n);
+		delta_win_len += n;
+		data += n;
+		len -= n;
+
+		if (delta_win_len == sizeof(delta_win)) {
+			err = delta_flush();
+		}
+	}
+
+	return err;
+}
+
+/* Source bytes are read straight into the window */
+static int delta_copy(uint32_t src_off, uint32_t len)
+{
+	int err = 0;
+
+	while (len > 0 && err == 0) {
+		size_t n = MIN(len, sizeof(delta_win) - delta_win_len);
+
+		err = flash_area_read(delta_src_fa, src_off, &delta_win[delta_win_len], n);
+		delta_win_len += n;
+		src_off += n;
+		len -= n;
+
+		if (err == 0 && delta_win_len == sizeof(delta_win)) {
+			err = delta_flush();
+		}
+	}
+
+	return err;
+}
+
+static int delta_hdr_check(void)
+{
+	const struct image_header *src = image_header_get(delta_src);
+	uint32_t out_size;
+
+	memcpy(&delta_hdr, delta_stage, sizeof(delta_hdr));
+	out_size = sys_le32_to_cpu(delta_hdr.out_size);
+
+	if (sys_le32_to_cpu(delta_hdr.magic) != DELTA_MAGIC) {
+		return -EINVAL;
+	}
+
+	if (out_size == 0 || out_size > delta_max_out) {
+		return -EFBIG;
+	}
+
+	/* The source is verified like any image the bootloader would start */
+	if (src == NULL || image_validate(delta_src) != 0 ||
+	    sys_le32_to_cpu(delta_hdr.src_size) != src->hdr_size + src->img_size ||
+	    memcmp(delta_hdr.src_sha256, src->sha256, sizeof(src->sha256)) != 0) {
+		LOG_ERR("Patch does not apply to the image in slot %d", delta_src);
+		return -ESTALE;
+	}
+
+	LOG_INF("Patching slot %d image into %u bytes", delta_src, out_size);
+
+	return 0;
+}
+
+static int delta_op_start(void)
+{
+	struct delta_op op;
+	uint32_t len;
+	uint32_t src_off;
+
+	memcpy(&op, delta_stage, sizeof(op));
+	len = sys_le32_to_cpu(op.len);
+	src_off = sys_le32_to_cpu(op.src_off);
+
+	if ((uint64_t)delta_produced + len > sys_le32_to_cpu(delta_hdr.out_size)) {
+		return -EFBIG;
+	}
+
+	delta_produced += len;
+
+	switch (op.op) {
+	case DELTA_OP_COPY:
+		if ((uint64_t)src_off + len > sys_le32_to_cpu(delta_hdr.src_size)) {
+			return -EINVAL;
+		}
+
+		return delta_copy(src_off, len);
+	case DELTA_OP_INSERT:
+		delta_insert_left = len;
+		delta_state = (len > 0) ? DELTA_STATE_INSERT : DELTA_STATE_OP;
+		return 0;
+	default:
+		return -EINVAL;
+	}
+}
+
+int delta_begin(enum image_slot src, size_t max_out, delta_emit_t emit)
+{
+	int err;
+
+	if (delta_src_fa == NULL || delta_src != src) {
+		if (delta_src_fa != NULL) {
+			flash_area_close(delta_src_fa);
+			delta_src_fa = NULL;
+		}
+
+		err = flash_area_open(image_slot_fa_id(src), &delta_src_fa);
+		if (err != 0) {
+			return err;
+		}
+	}
+
+	delta_src = src;
+	delta_max_out = max_out;
+	delta_emit = emit;
+	delta_state = DELTA_STATE_HDR;
+	delta_stage_len = 0;
+	delta_insert_left = 0;
+	delta_produced = 0;
+	delta_win_len = 0;
+	delta_out_off = 0;
+
+	return 0;
+}
+
+int delta_feed(const uint8_t *data, size_t len)
+{
+	int err = 0;
+
+	while (len > 0 && err == 0) {
+		size_t need;
+		size_t n;
+
+		if (delta_state == DELTA_STATE_INSERT) {
+			n = MIN(len, delta_insert_left);
+			err = delta_out(data, n);
+			delta_insert_left -= n;
+			if (delta_insert_left == 0) {
+				delta_state = DELTA_STATE_OP;
+			}
+		} else {
+			/* Headers may straddle two chunks */
+			need = (delta_state == DELTA_STATE_HDR) ?
+			       sizeof(struct delta_hdr) : sizeof(struct delta_op);
+			n = MIN(len, need - delta_stage_len);
+			memcpy(&delta_stage[delta_stage_len], data, n);
+			delta_stage_len += n;
+
+			if (delta_stage_len == need) {
+				delta_stage_len = 0;
+				if (delta_state == DELTA_STATE_HDR) {
+					err = delta_hdr_check();
+					delta_state = DELTA_STATE_OP;
+				} else {
+					err = delta_op_start();
+				}
+			}
+		}
+
+		data += n;
+		len -= n;
+	}
+
+	return err;
+}
+
+int delta_finish(size_t *out_size)
+{
+	if (delta_state != DELTA_STATE_OP || delta_stage_len != 0 ||
+	    delta_produced != sys_le32_to_cpu(delta_hdr.out_size)) {
+		return -ENODATA;
+	}
+
+	*out_size = delta_produced;
+
+	return delta_flush();
+}
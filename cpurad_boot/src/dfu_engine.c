@@ -0,0 +1,487 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/logging/log.h>
+#include <psa/crypto.h>
+#include <dfu_engine.h>
+#include <dfu_state.h>
+#include <delta.h>
+#include <unlz4.h>
+#include <image.h>
+#include <mram.h>
+#include <timeline.h>
+
+LOG_MODULE_REGISTER(dfu_engine, LOG_LEVEL_INF);
+
+static K_FIFO_DEFINE(dfu_write_fifo);
+static K_SEM_DEFINE(dfu_idle_sem, 0, 1);
+
+static const struct flash_area *dfu_fa;
+static enum image_slot dfu_slot = IMAGE_SLOT_SECONDARY;
+static dfu_notify_t dfu_notify_cb;
+/* Bytes the host sends: the image, a patch or a compressed image */
+static size_t dfu_image_size;
+/* Bytes written to the slot, known at the end of a delta or LZ4 session */
+static size_t dfu_out_size;
+static enum dfu_format dfu_format;
+static uint32_t dfu_stream_off;
+/* Raw session whose progress is kept in boot_dfu_state_partition */
+static bool dfu_persist;
+static atomic_t dfu_pending;
+static atomic_t dfu_error;
+static struct dfu_engine_stats dfu_stats;
+static uint32_t dfu_start_cycles;
+static struct mram_stats dfu_mram_start;
+
+/* SHA-256 over the image, fed chunk by chunk from the receive buffers */
+static psa_hash_operation_t dfu_hash_op;
+static uint32_t dfu_hash_off;
+static bool dfu_hash_in_order;
+static bool dfu_has_expected;
+static uint8_t dfu_expected[DFU_DIGEST_SIZE];
+static uint8_t dfu_digest[DFU_DIGEST_SIZE];
+
+void dfu_engine_notify(enum dfu_notify evt)
+{
+	if (dfu_notify_cb != NULL) {
+		dfu_notify_cb(evt);
+	}
+}
+
+const uint8_t *dfu_engine_resume_map(size_t *len)
+{
+	if (!IS_ENABLED(CONFIG_RAD_BOOT_DFU_RESUME) || dfu_image_size == 0 || !dfu_persist) {
+		return NULL;
+	}
+
+	return dfu_state_bitmap(len);
+}
+
+size_t dfu_engine_write_align(void)
+{
+	return dfu_fa != NULL ? flash_area_align(dfu_fa) : 1;
+}
+
+/*
+ * Hash output while it is still in RAM. Data that does not continue the
+ * hashed prefix (retransmission, out of order delivery) makes
+ * dfu_engine_end() fall back to hashing the partition.
+ */
+static void dfu_hash_data(uint32_t off, const uint8_t *data, size_t len)
+{
+	uint32_t start = timeline_now();
+
+	if (!dfu_hash_in_order || off != dfu_hash_off) {
+		dfu_hash_in_order = false;
+		return;
+	}
+
+	if (psa_hash_update(&dfu_hash_op, data, len) != PSA_SUCCESS) {
+		dfu_hash_in_order = false;
+		return;
+	}
+
+	dfu_hash_off += len;
+	dfu_stats.hash_cycles += timeline_now() - start;
+}
+
+/* Second pass over the written partition, only used as fallback */
+static int dfu_hash_partition(void)
+{
+	uint8_t buf[256];
+	uint32_t start = timeline_now();
+	int err = 0;
+
+	(void)psa_hash_abort(&dfu_hash_op);
+	if (psa_hash_setup(&dfu_hash_op, PSA_ALG_SHA_256) != PSA_SUCCESS) {
+		return -EIO;
+	}
+
+	for (size_t off = 0; off < dfu_out_size && err == 0; off += sizeof(buf)) {
+		size_t len = MIN(sizeof(buf), dfu_out_size - off);
+
+		err = flash_area_read(dfu_fa, off, buf, len);
+		if (err == 0 && psa_hash_update(&dfu_hash_op, buf, len) != PSA_SUCCESS) {
+			err = -EIO;
+		}
+	}
+
+	dfu_stats.hash_cycles += timeline_now() - start;
+
+	return err;
+}
+
+static int dfu_hash_finish(void)
+{
+	size_t len;
+	int err = 0;
+
+	if (!dfu_hash_in_order || dfu_hash_off != dfu_out_size) {
+		LOG_WRN("Chunks out of order, re-reading partition for digest");
+		err = dfu_hash_partition();
+	}
+
+	if (err == 0 &&
+	    psa_hash_finish(&dfu_hash_op, dfu_digest, sizeof(dfu_digest), &len) != PSA_SUCCESS) {
+		err = -EIO;
+	}
+
+	if (err != 0) {
+		(void)psa_hash_abort(&dfu_hash_op);
+		return err;
+	}
+
+	if (dfu_has_expected && memcmp(dfu_digest, dfu_expected, sizeof(dfu_digest)) != 0) {
+		LOG_ERR("Image digest mismatch");
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+/*
+ * Program @p len bytes at @p off. Only the last write of an image may be
+ * short; its padding is not part of @p len, so it never reaches the hash.
+ */
+static int dfu_out_write(uint32_t off, uint8_t *data, size_t len)
+{
+	size_t wlen = ROUND_UP(len, flash_area_align(dfu_fa));
+	uint32_t start = timeline_now();
+	int err;
+
+	memset(&data[len], 0xFF, wlen - len);
+	err = mram_write(dfu_fa, off, data, wlen);
+
+	dfu_stats.write_cycles += timeline_now() - start;
+
+	return err;
+}
+
+/* Output of the patcher or decompressor, always in order */
+static int dfu_stream_emit(uint32_t off, uint8_t *data, size_t len)
+{
+	int err = dfu_out_write(off, data, len);
+
+	if (err == 0) {
+		dfu_hash_data(off, data, len);
+	}
+
+	return err;
+}
+
+static int dfu_stream_chunk(struct dfu_chunk *chunk)
+{
+	int err;
+
+	/* Patches and compressed streams can only be decoded front to back */
+	if (chunk->offset != dfu_stream_off) {
+		return -EINVAL;
+	}
+
+	if (IS_ENABLED(CONFIG_RAD_BOOT_DFU_DELTA) && dfu_format == DFU_FORMAT_DELTA) {
+		err = delta_feed(chunk->data, chunk->len);
+	} else if (IS_ENABLED(CONFIG_RAD_BOOT_DFU_LZ4) && dfu_format == DFU_FORMAT_LZ4) {
+		err = unlz4_feed(chunk->data, chunk->len);
+	} else {
+		err = -ENOTSUP;
+	}
+
+	dfu_stream_off += chunk->len;
+
+	return err;
+}
+
+static void dfu_write_chunk(struct dfu_chunk *chunk)
+{
+	int err;
+
+	if (atomic_get(&dfu_error) != 0) {
+		err = -ECANCELED;
+	} else if (dfu_format != DFU_FORMAT_RAW) {
+		err = dfu_stream_chunk(chunk);
+	} else {
+		err = dfu_out_write(chunk->offset, chunk->data, chunk->len);
+		if (err == 0) {
+			dfu_hash_data(chunk->offset, chunk->data, chunk->len);
+		}
+		if (IS_ENABLED(CONFIG_RAD_BOOT_DFU_RESUME) && err == 0 && dfu_persist) {
+			dfu_state_mark(chunk->offset);
+		}
+	}
+
+	if (err != 0) {
+		atomic_cas(&dfu_error, 0, err);
+	} else {
+		dfu_stats.bytes += chunk->len;
+		dfu_stats.chunks++;
+	}
+
+	chunk->done(chunk, err);
+
+	if (atomic_dec(&dfu_pending) == 1) {
+		dfu_stats.total_cycles = timeline_now() - dfu_start_cycles;
+		k_sem_give(&dfu_idle_sem);
+	}
+}
+
+static void dfu_writer_thread(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		struct dfu_chunk *chunk = k_fifo_get(&dfu_write_fifo, K_FOREVER);
+
+		dfu_write_chunk(chunk);
+	}
+}
+
+K_THREAD_DEFINE(dfu_writer, CONFIG_RAD_BOOT_DFU_WRITER_STACK_SIZE,
+		dfu_writer_thread, NULL, NULL, NULL,
+		CONFIG_RAD_BOOT_DFU_WRITER_PRIO, 0, 0);
+
+void dfu_engine_init(dfu_notify_t notify)
+{
+	dfu_notify_cb = notify;
+}
+
+void dfu_engine_set_slot(enum image_slot slot)
+{
+	if (dfu_fa != NULL && slot != dfu_slot) {
+		flash_area_close(dfu_fa);
+		dfu_fa = NULL;
+	}
+
+	dfu_slot = slot;
+}
+
+enum image_slot dfu_engine_slot(void)
+{
+	return dfu_slot;
+}
+
+int dfu_engine_begin(size_t size, const uint8_t *digest, enum dfu_format format)
+{
+	static const char *const format_str[] = {
+		[DFU_FORMAT_RAW] = "image",
+		[DFU_FORMAT_DELTA] = "patch",
+		[DFU_FORMAT_LZ4] = "LZ4",
+	};
+	int err;
+
+	if ((format == DFU_FORMAT_DELTA && !IS_ENABLED(CONFIG_RAD_BOOT_DFU_DELTA)) ||
+	    (format == DFU_FORMAT_LZ4 && !IS_ENABLED(CONFIG_RAD_BOOT_DFU_LZ4)) ||
+	    format >= ARRAY_SIZE(format_str)) {
+		return -ENOTSUP;
+	}
+
+	if (atomic_get(&dfu_pending) != 0) {
+		return -EBUSY;
+	}
+
+	if (psa_crypto_init() != PSA_SUCCESS) {
+		return -EIO;
+	}
+
+	if (dfu_fa == NULL) {
+		err = flash_area_open(image_slot_fa_id(dfu_slot), &dfu_fa);
+		if (err != 0) {
+			LOG_ERR("Cannot open DFU partition, %d", err);
+			return err;
+		}
+	}
+
+	if (size == 0 || size > dfu_fa->fa_size) {
+		return -EFBIG;
+	}
+
+	if (IS_ENABLED(CONFIG_RAD_BOOT_DFU_DELTA) && format == DFU_FORMAT_DELTA) {
+		/* The patch reads the image in the other slot */
+		err = delta_begin(dfu_slot == IMAGE_SLOT_PRIMARY ?
+				  IMAGE_SLOT_SECONDARY : IMAGE_SLOT_PRIMARY,
+				  dfu_fa->fa_size, dfu_stream_emit);
+		if (err != 0) {
+			return err;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_RAD_BOOT_DFU_LZ4) && format == DFU_FORMAT_LZ4) {
+		unlz4_begin(dfu_fa, dfu_fa->fa_size, dfu_stream_emit);
+	}
+
+	(void)psa_hash_abort(&dfu_hash_op);
+	if (psa_hash_setup(&dfu_hash_op, PSA_ALG_SHA_256) != PSA_SUCCESS) {
+		return -EIO;
+	}
+
+	dfu_hash_off = 0;
+	dfu_hash_in_order = true;
+	dfu_has_expected = (digest != NULL);
+	if (digest != NULL) {
+		memcpy(dfu_expected, digest, sizeof(dfu_expected));
+	}
+
+	image_cache_invalidate(dfu_slot);
+
+	dfu_persist = IS_ENABLED(CONFIG_RAD_BOOT_DFU_RESUME) &&
+		      format == DFU_FORMAT_RAW && digest != NULL;
+	if (dfu_persist && dfu_state_begin(dfu_slot, size, digest)) {
+		LOG_INF("Resuming, %u of %u chunks missing", dfu_state_missing(),
+			DIV_ROUND_UP(size, CONFIG_RAD_BOOT_DFU_CHUNK_SIZE));
+		/* Earlier chunks are not in the running hash */
+		dfu_hash_in_order = false;
+	}
+
+	dfu_image_size = size;
+	dfu_out_size = size;
+	dfu_format = format;
+	dfu_stream_off = 0;
+	atomic_set(&dfu_error, 0);
+	memset(&dfu_stats, 0, sizeof(dfu_stats));
+	k_sem_reset(&dfu_idle_sem);
+	mram_stats_get(&dfu_mram_start);
+	dfu_start_cycles = timeline_now();
+
+	LOG_INF("Receiving %u %s bytes into 0x%lx", size, format_str[format],
+		(unsigned long)dfu_fa->fa_off);
+	dfu_engine_notify(DFU_NOTIFY_ACTIVITY);
+
+	return 0;
+}
+
+int dfu_engine_submit(struct dfu_chunk *chunk)
+{
+	if (dfu_image_size == 0 || atomic_get(&dfu_error) != 0) {
+		return -EIO;
+	}
+
+	if ((chunk->offset % flash_area_align(dfu_fa)) != 0 ||
+	    chunk->offset + chunk->len > dfu_image_size) {
+		return -EINVAL;
+	}
+
+	/* Progress is tracked per chunk, so only whole chunks count */
+	if (dfu_persist &&
+	    ((chunk->offset % CONFIG_RAD_BOOT_DFU_CHUNK_SIZE) != 0 ||
+	     chunk->len > CONFIG_RAD_BOOT_DFU_CHUNK_SIZE ||
+	     (chunk->len != CONFIG_RAD_BOOT_DFU_CHUNK_SIZE &&
+	      chunk->offset + chunk->len != dfu_image_size))) {
+		return -EINVAL;
+	}
+
+	atomic_inc(&dfu_pending);
+	k_fifo_put(&dfu_write_fifo, chunk);
+	dfu_engine_notify(DFU_NOTIFY_ACTIVITY);
+
+	return 0;
+}
+
+int dfu_engine_end(k_timeout_t timeout)
+{
+	struct mram_stats mram;
+	int err;
+
+	if (atomic_get(&dfu_pending) != 0 &&
+	    k_sem_take(&dfu_idle_sem, timeout) != 0) {
+		return -ETIMEDOUT;
+	}
+
+	err = (int)atomic_get(&dfu_error);
+	if (IS_ENABLED(CONFIG_RAD_BOOT_DFU_RESUME) && dfu_persist) {
+		/* Chunks may have arrived in an earlier session */
+		if (err == 0 && dfu_state_missing() != 0) {
+			err = -ENODATA;
+		}
+	} else if (err == 0 && dfu_stats.bytes != dfu_image_size) {
+		err = -ENODATA;
+	}
+
+	if (IS_ENABLED(CONFIG_RAD_BOOT_DFU_DELTA) && err == 0 &&
+	    dfu_format == DFU_FORMAT_DELTA) {
+		err = delta_finish(&dfu_out_size);
+	}
+
+	if (IS_ENABLED(CONFIG_RAD_BOOT_DFU_LZ4) && err == 0 &&
+	    dfu_format == DFU_FORMAT_LZ4) {
+		err = unlz4_finish(&dfu_out_size);
+	}
+
+	mram_stats_get(&mram);
+	dfu_stats.blocks_written = mram.blocks_written - dfu_mram_start.blocks_written;
+	dfu_stats.blocks_skipped = mram.blocks_skipped - dfu_mram_start.blocks_skipped;
+
+	if (err == 0) {
+		err = dfu_hash_finish();
+	} else {
+		(void)psa_hash_abort(&dfu_hash_op);
+	}
+
+	/* The slot is memory mapped, check the header where it landed */
+	if (err == 0) {
+		const struct image_header *hdr = image_header_get(dfu_slot);
+
+		if (hdr != NULL && hdr->load_addr != image_load_addr(dfu_slot)) {
+			LOG_ERR("Image linked for 0x%08x, slot %d runs 0x%08x",
+				hdr->load_addr, dfu_slot, image_load_addr(dfu_slot));
+			err = -ENOEXEC;
+		}
+	}
+
+	if (err == 0) {
+		uint32_t us = timeline_cyc_to_us(dfu_stats.total_cycles);
+		uint32_t kb = MAX(dfu_stats.bytes / 1024, 1);
+
+		LOG_INF("Image written: %u bytes in %u us (%u KB/s), MRAM busy %u us",
+			dfu_stats.bytes, us,
+			us ? (uint32_t)((uint64_t)dfu_stats.bytes * 1000000 / 1024 / us) : 0,
+			timeline_cyc_to_us(dfu_stats.write_cycles));
+		LOG_INF("MRAM: %u blocks written, %u unchanged blocks skipped",
+			dfu_stats.blocks_written, dfu_stats.blocks_skipped);
+		LOG_INF("SHA-256 verify: %u us total, %u cycles/KB",
+			timeline_cyc_to_us(dfu_stats.hash_cycles),
+			dfu_stats.hash_cycles / kb);
+		if (dfu_format != DFU_FORMAT_RAW) {
+			LOG_INF("%s: %u bytes received for %u image bytes (%u%%)",
+				dfu_format == DFU_FORMAT_DELTA ? "Delta" : "LZ4",
+				dfu_stats.bytes, dfu_out_size,
+				(uint32_t)((uint64_t)dfu_stats.bytes * 100 / dfu_out_size));
+		}
+	}
+
+	/* Missing chunks can still be sent, anything else is final */
+	if (IS_ENABLED(CONFIG_RAD_BOOT_DFU_RESUME) && dfu_persist &&
+	    err != -ENODATA && err != -ETIMEDOUT) {
+		dfu_state_clear();
+	}
+
+	dfu_image_size = 0;
+	if (err != 0) {
+		dfu_engine_notify(DFU_NOTIFY_ERROR);
+	}
+
+	return err;
+}
+
+void dfu_engine_abort(void)
+{
+	atomic_cas(&dfu_error, 0, -ECANCELED);
+	dfu_image_size = 0;
+}
+
+void dfu_engine_stats_get(struct dfu_engine_stats *stats)
+{
+	*stats = dfu_stats;
+}
+
+const uint8_t *dfu_engine_digest(void)
+{
+	return dfu_digest;
+}
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * DFU packets carried in HID reports, see dfu_proto.h.
+ *
+ * An output report holds less than a chunk, so DATA payload is collected
+ * into CONFIG_RAD_BOOT_DFU_CHUNK_SIZE buffers before it goes to the DFU
+ * engine. While the engine programs one buffer the next one is filled.
+ * When none is free the report callback waits, the OUT endpoint is not
+ * re-armed and the host is held off by NAKs, so it can write reports
+ * back to back without waiting for a status.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+#include <dfu_engine.h>
+#include <dfu_hid.h>
+#include <dfu_proto.h>
+
+LOG_MODULE_REGISTER(dfu_hid, LOG_LEVEL_INF);
+
+#define DFU_HID_CHUNK_SIZE      CONFIG_RAD_BOOT_DFU_CHUNK_SIZE
+
+BUILD_ASSERT(DT_PROP(DT_NODELABEL(hid_dev_0), out_report_size) >= DFU_HID_DATA_SIZE + 1,
+	     "hid_dev_0 out-report-size too small for DFU output reports");
+
+struct dfu_hid_buf {
+	struct dfu_chunk chunk;
+	uint8_t data[DFU_HID_CHUNK_SIZE] __aligned(4);
+};
+
+K_MEM_SLAB_DEFINE_STATIC(dfu_hid_slab, sizeof(struct dfu_hid_buf),
+			 CONFIG_RAD_BOOT_DFU_BUF_COUNT, 4);
+
+/* Buffer being filled, NULL between chunks */
+static struct dfu_hid_buf *dfu_hid_cur;
+/* Bytes announced by BEGIN */
+static uint32_t dfu_hid_size;
+static struct dfu_hid_status dfu_hid_st;
+/* Updated from the DFU engine thread */
+static atomic_t dfu_hid_written;
+static atomic_t dfu_hid_data_err;
+
+static void dfu_hid_chunk_done(struct dfu_chunk *chunk, int err)
+{
+	if (err != 0) {
+		(void)atomic_cas(&dfu_hid_data_err, 0, -err);
+	} else {
+		(void)atomic_add(&dfu_hid_written, chunk->len);
+	}
+
+	k_mem_slab_free(&dfu_hid_slab, CONTAINER_OF(chunk, struct dfu_hid_buf, chunk));
+}
+
+static void dfu_hid_drop(void)
+{
+	if (dfu_hid_cur != NULL) {
+		k_mem_slab_free(&dfu_hid_slab, dfu_hid_cur);
+		dfu_hid_cur = NULL;
+	}
+}
+
+static int dfu_hid_flush(void)
+{
+	int err;
+
+	if (dfu_hid_cur == NULL) {
+		return 0;
+	}
+
+	err = dfu_engine_submit(&dfu_hid_cur->chunk);
+	if (err != 0) {
+		k_mem_slab_free(&dfu_hid_slab, dfu_hid_cur);
+	}
+
+	dfu_hid_cur = NULL;
+
+	return err;
+}
+
+static int dfu_hid_data(uint32_t offset, const uint8_t *data, size_t len)
+{
+	struct dfu_chunk *chunk;
+	size_t n;
+	int err;
+
+	while (len > 0) {
+		if (dfu_hid_cur == NULL) {
+			/* Resumed transfers skip whole chunks, so a buffer
+			 * always starts on a chunk boundary
+			 */
+			if ((offset % DFU_HID_CHUNK_SIZE) != 0) {
+				return -EINVAL;
+			}
+
+			if (k_mem_slab_alloc(&dfu_hid_slab, (void **)&dfu_hid_cur,
+					     K_MSEC(CONFIG_RAD_BOOT_DFU_END_TIMEOUT_MS)) != 0) {
+				dfu_hid_cur = NULL;
+				return -ENOBUFS;
+			}
+
+			chunk = &dfu_hid_cur->chunk;
+			chunk->offset = offset;
+			chunk->data = dfu_hid_cur->data;
+			chunk->len = 0;
+			chunk->done = dfu_hid_chunk_done;
+			chunk->user_data = NULL;
+		}
+
+		chunk = &dfu_hid_cur->chunk;
+		if (offset != chunk->offset + chunk->len) {
+			return -EINVAL;
+		}
+
+		n = MIN(len, DFU_HID_CHUNK_SIZE - chunk->len);
+		memcpy(&chunk->data[chunk->len], data, n);
+		chunk->len += n;
+		offset += n;
+		data += n;
+		len -= n;
+
+		if (chunk->len == DFU_HID_CHUNK_SIZE || offset >= dfu_hid_size) {
+			err = dfu_hid_flush();
+			if (err != 0) {
+				return err;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static int dfu_hid_begin(uint32_t size, uint8_t flags, const uint8_t *digest)
+{
+	enum dfu_format format;
+	int err;
+
+	switch (flags & (DFU_FLAG_DELTA | DFU_FLAG_LZ4)) {
+	case 0:
+		format = DFU_FORMAT_RAW;
+		break;
+	case DFU_FLAG_DELTA:
+		format = DFU_FORMAT_DELTA;
+		break;
+	case DFU_FLAG_LZ4:
+		format = DFU_FORMAT_LZ4;
+		break;
+	default:
+		return -ENOTSUP;
+	}
+
+	dfu_hid_drop();
+	err = dfu_engine_begin(size, digest, format);
+	if (err == 0) {
+		dfu_hid_size = size;
+		atomic_set(&dfu_hid_written, 0);
+		atomic_set(&dfu_hid_data_err, 0);
+	}
+
+	return err;
+}
+
+void dfu_hid_output(const uint8_t *buf, uint16_t len)
+{
+	struct dfu_pkt_hdr hdr;
+	const uint8_t *payload = buf + 1 + sizeof(hdr);
+	const uint8_t *map;
+	size_t map_len = 0;
+	uint32_t offset;
+	uint16_t plen;
+	int err;
+
+	if (len < 1 + sizeof(hdr) || buf[0] != DFU_HID_DATA_REPORT_ID) {
+		return;
+	}
+
+	memcpy(&hdr, buf + 1, sizeof(hdr));
+	offset = sys_le32_to_cpu(hdr.offset);
+	plen = sys_le16_to_cpu(hdr.len);
+	if (plen > len - 1 - sizeof(hdr)) {
+		err = -EMSGSIZE;
+		goto out;
+	}
+
+	switch (hdr.cmd) {
+	case DFU_CMD_BEGIN:
+		if (plen != DFU_DIGEST_SIZE) {
+			err = -EINVAL;
+			break;
+		}
+
+		err = dfu_hid_begin(offset, hdr.flags, payload);
+		/* BEGIN answers with the address the image has to be linked for */
+		offset = image_load_addr(dfu_engine_slot());
+		break;
+	case DFU_CMD_DATA:
+		/* Not answered, a failure shows up in data_status */
+		if (atomic_get(&dfu_hid_data_err) == 0) {
+			err = dfu_hid_data(offset, payload, plen);
+			if (err != 0) {
+				(void)atomic_cas(&dfu_hid_data_err, 0, -err);
+			}
+		}
+		return;
+	case DFU_CMD_END:
+		err = dfu_hid_flush();
+		if (err != 0) {
+			(void)atomic_cas(&dfu_hid_data_err, 0, -err);
+		}
+
+		err = dfu_engine_end(K_MSEC(CONFIG_RAD_BOOT_DFU_END_TIMEOUT_MS));
+		break;
+	case DFU_CMD_ABORT:
+		dfu_hid_drop();
+		dfu_engine_abort();
+		err = 0;
+		break;
+	case DFU_CMD_QUERY:
+		map = dfu_engine_resume_map(&map_len);
+		if (map == NULL || map_len > sizeof(dfu_hid_st.map)) {
+			map_len = 0;
+			err = -ENODATA;
+			break;
+		}
+
+		memcpy(dfu_hid_st.map, map, map_len);
+		offset = DFU_HID_CHUNK_SIZE;
+		err = 0;
+		break;
+	default:
+		err = -ENOTSUP;
+		break;
+	}
+
+out:
+	dfu_hid_st.rsp.cmd = hdr.cmd;
+	dfu_hid_st.rsp.status = (uint8_t)(-err);
+	dfu_hid_st.rsp.window = CONFIG_RAD_BOOT_DFU_BUF_COUNT;
+	dfu_hid_st.rsp.offset = sys_cpu_to_le32(offset);
+	dfu_hid_st.map_len = sys_cpu_to_le16(map_len);
+}
+
+int dfu_hid_status_get(uint8_t *buf, uint16_t len)
+{
+	if (len < 1 + sizeof(dfu_hid_st)) {
+		return 0;
+	}
+
+	dfu_hid_st.written = sys_cpu_to_le32((uint32_t)atomic_get(&dfu_hid_written));
+	dfu_hid_st.data_status = (uint8_t)atomic_get(&dfu_hid_data_err);
+
+	buf[0] = DFU_HID_STATUS_REPORT_ID;
+	memcpy(&buf[1], &dfu_hid_st, sizeof(dfu_hid_st));
+
+	/* The session is over once the host has read the final status */
+	if (dfu_hid_st.rsp.cmd == DFU_CMD_END && dfu_hid_st.rsp.status == 0) {
+		dfu_engine_notify(DFU_NOTIFY_DONE);
+	}
+
+	return 1 + sizeof(dfu_hid_st);
+}
+
+void dfu_hid_disable(void)
+{
+	dfu_hid_drop();
+	dfu_engine_abort();
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/logging/log.h>
+#include <dfu_engine.h>
+#include <dfu_state.h>
+#include <mram.h>
+
+LOG_MODULE_REGISTER(dfu_state, LOG_LEVEL_INF);
+
+#define DFU_STATE_PARTITION     DT_NODELABEL(boot_dfu_state_partition)
+#define DFU_STATE_MAGIC         0x53554644 /* "DFUS" */
+#define DFU_STATE_CHUNK_SIZE    CONFIG_RAD_BOOT_DFU_CHUNK_SIZE
+#define DFU_STATE_SLOT_MAX      MAX(DT_REG_SIZE(DT_NODELABEL(cpurad_app_partition)), \
+				    DT_REG_SIZE(DT_NODELABEL(cpurad_app2_partition)))
+#define DFU_STATE_MAP_SIZE      ROUND_UP(DIV_ROUND_UP(DFU_STATE_SLOT_MAX, \
+						      DFU_STATE_CHUNK_SIZE * 8), 16)
+
+struct dfu_state_rec {
+	uint32_t magic;
+	uint32_t size;
+	uint32_t chunk_size;
+	uint32_t slot;
+	uint8_t digest[DFU_DIGEST_SIZE];
+	uint32_t crc;
+	uint32_t reserved[3];
+};
+
+BUILD_ASSERT(sizeof(struct dfu_state_rec) % 16 == 0,
+	     "dfu_state_rec must be a multiple of the MRAM write block");
+BUILD_ASSERT(sizeof(struct dfu_state_rec) + DFU_STATE_MAP_SIZE <=
+	     DT_REG_SIZE(DFU_STATE_PARTITION),
+	     "boot_dfu_state_partition too small for the chunk bitmap");
+
+static const struct flash_area *dfu_state_fa;
+static uint32_t dfu_state_chunks;
+/* RAM copy of the persisted bitmap */
+static uint8_t dfu_state_map[DFU_STATE_MAP_SIZE];
+
+static uint32_t dfu_state_crc(const struct dfu_state_rec *rec)
+{
+	return crc32_ieee((const uint8_t *)rec, offsetof(struct dfu_state_rec, crc));
+}
+
+bool dfu_state_begin(enum image_slot slot, uint32_t size, const uint8_t *digest)
+{
+	struct dfu_state_rec rec;
+
+	dfu_state_chunks = DIV_ROUND_UP(size, DFU_STATE_CHUNK_SIZE);
+
+	if (dfu_state_fa == NULL &&
+	    flash_area_open(FIXED_PARTITION_ID(boot_dfu_state_partition), &dfu_state_fa) != 0) {
+		dfu_state_fa = NULL;
+		memset(dfu_state_map, 0, sizeof(dfu_state_map));
+		return false;
+	}
+
+	if (flash_area_read(dfu_state_fa, 0, &rec, sizeof(rec)) == 0 &&
+	    rec.magic == DFU_STATE_MAGIC && rec.crc == dfu_state_crc(&rec) &&
+	    rec.size == size && rec.chunk_size == DFU_STATE_CHUNK_SIZE && rec.slot == slot &&
+	    memcmp(rec.digest, digest, sizeof(rec.digest)) == 0 &&
+	    flash_area_read(dfu_state_fa, sizeof(rec), dfu_state_map,
+			    sizeof(dfu_state_map)) == 0) {
+		return true;
+	}
+
+	memset(&rec, 0, sizeof(rec));
+	rec.magic = DFU_STATE_MAGIC;
+	rec.size = size;
+	rec.chunk_size = DFU_STATE_CHUNK_SIZE;
+	rec.slot = slot;
+	memcpy(rec.digest, digest, sizeof(rec.digest));
+	rec.crc = dfu_state_crc(&rec);
+
+	/* Bitmap first, so a reset in between cannot pair the new record
+	 * with the bits of an older session.
+	 */
+	memset(dfu_state_map, 0, sizeof(dfu_state_map));
+	if (mram_write(dfu_state_fa, sizeof(rec), dfu_state_map, sizeof(dfu_state_map)) != 0 ||
+	    mram_write(dfu_state_fa, 0, &rec, sizeof(rec)) != 0) {
+		LOG_WRN("Cannot persist DFU session");
+	}
+
+	return false;
+}
+
+void dfu_state_mark(uint32_t offset)
+{
+	uint32_t chunk = offset / DFU_STATE_CHUNK_SIZE;
+	uint32_t byte = chunk / 8;
+
+	if (chunk >= dfu_state_chunks) {
+		return;
+	}
+
+	dfu_state_map[byte] |= BIT(chunk % 8);
+
+	if (dfu_state_fa != NULL) {
+		(void)mram_write(dfu_state_fa, sizeof(struct dfu_state_rec) + byte,
+				 &dfu_state_map[byte], 1);
+	}
+}
+
+uint32_t dfu_state_missing(void)
+{
+	uint32_t missing = 0;
+
+	for (uint32_t chunk = 0; chunk < dfu_state_chunks; chunk++) {
+		if (!(dfu_state_map[chunk / 8] & BIT(chunk % 8))) {
+			missing++;
+		}
+	}
+
+	return missing;
+}
+
+const uint8_t *dfu_state_bitmap(size_t *len)
+{
+	*len = DIV_ROUND_UP(dfu_state_chunks, 8);
+
+	return dfu_state_map;
+}
+
+void dfu_state_clear(void)
+{
+	struct dfu_state_rec rec = { 0 };
+
+	if (dfu_state_fa != NULL) {
+		(void)mram_write(dfu_state_fa, 0, &rec, sizeof(rec));
+	}
+}
+
+#ifdef CONFIG_ZTEST
+void dfu_state_test_reset(void)
+{
+	memset(dfu_state_map, 0xA5, sizeof(dfu_state_map));
+	dfu_state_chunks = 0;
+}
+#endif
@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * Vendor specific USB interface with one bulk OUT and one bulk IN endpoint
+ * carrying the packets described in dfu_proto.h.
+ *
+ * CONFIG_RAD_BOOT_DFU_BUF_COUNT OUT transfers are kept queued at the
+ * controller, each in its own buffer from the UDC pool. While the DFU
+ * engine programs the chunk held by one buffer, the controller receives
+ * the next chunk into another. A buffer goes back to the pool, and a fresh
+ * OUT transfer is queued, only once its chunk has been written.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/usb/usbd.h>
+#include <zephyr/drivers/usb/udc.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+#include <dfu_engine.h>
+#include <dfu_proto.h>
+
+LOG_MODULE_REGISTER(dfu_usb, LOG_LEVEL_INF);
+
+#define DFU_USB_FS_MPS          64U
+#define DFU_USB_HS_MPS          512U
+
+/* OUT transfers must be a multiple of the packet size */
+#define DFU_USB_BUF_SIZE        ROUND_UP(sizeof(struct dfu_pkt_hdr) + \
+					 CONFIG_RAD_BOOT_DFU_CHUNK_SIZE, DFU_USB_HS_MPS)
+/* The DFU engine pads the last write of an image to the MRAM write unit
+ * in place, behind the chunk data
+ */
+#define DFU_USB_WRITE_BLOCK     16
+
+BUILD_ASSERT(sizeof(struct dfu_pkt_hdr) +
+	     ROUND_UP(CONFIG_RAD_BOOT_DFU_CHUNK_SIZE, DFU_USB_WRITE_BLOCK) <= DFU_USB_BUF_SIZE,
+	     "DFU OUT buffer has no room for the write unit padding");
+
+#define DFU_USB_ENABLED         0
+
+struct dfu_usb_desc {
+	struct usb_if_descriptor if0;
+	struct usb_ep_descriptor if0_out_ep;
+	struct usb_ep_descriptor if0_in_ep;
+	struct usb_ep_descriptor if0_hs_out_ep;
+	struct usb_ep_descriptor if0_hs_in_ep;
+	struct usb_desc_header nil_desc;
+};
+
+static struct dfu_usb_desc dfu_usb_desc = {
+	.if0 = {
+		.bLength = sizeof(struct usb_if_descriptor),
+		.bDescriptorType = USB_DESC_INTERFACE,
+		.bInterfaceNumber = 0,
+		.bAlternateSetting = 0,
+		.bNumEndpoints = 2,
+		.bInterfaceClass = DFU_USB_CLASS,
+		.bInterfaceSubClass = DFU_USB_SUBCLASS,
+		.bInterfaceProtocol = DFU_USB_PROTOCOL,
+		.iInterface = 0,
+	},
+
+	.if0_out_ep = {
+		.bLength = sizeof(struct usb_ep_descriptor),
+		.bDescriptorType = USB_DESC_ENDPOINT,
+		.bEndpointAddress = 0x01,
+		.bmAttributes = USB_EP_TYPE_BULK,
+		.wMaxPacketSize = sys_cpu_to_le16(DFU_USB_FS_MPS),
+		.bInterval = 0x00,
+	},
+
+	.if0_in_ep = {
+		.bLength = sizeof(struct usb_ep_descriptor),
+		.bDescriptorType = USB_DESC_ENDPOINT,
+		.bEndpointAddress = 0x81,
+		.bmAttributes = USB_EP_TYPE_BULK,
+		.wMaxPacketSize = sys_cpu_to_le16(DFU_USB_FS_MPS),
+		.bInterval = 0x00,
+	},
+
+	.if0_hs_out_ep = {
+		.bLength = sizeof(struct usb_ep_descriptor),
+		.bDescriptorType = USB_DESC_ENDPOINT,
+		.bEndpointAddress = 0x01,
+		.bmAttributes = USB_EP_TYPE_BULK,
+		.wMaxPacketSize = sys_cpu_to_le16(DFU_USB_HS_MPS),
+		.bInterval = 0x00,
+	},
+
+	.if0_hs_in_ep = {
+		.bLength = sizeof(struct usb_ep_descriptor),
+		.bDescriptorType = USB_DESC_ENDPOINT,
+		.bEndpointAddress = 0x81,
+		.bmAttributes = USB_EP_TYPE_BULK,
+		.wMaxPacketSize = sys_cpu_to_le16(DFU_USB_HS_MPS),
+		.bInterval = 0x00,
+	},
+
+	.nil_desc = {
+		.bLength = 0,
+		.bDescriptorType = 0,
+	},
+};
+
+static const struct usb_desc_header *dfu_usb_fs_desc[] = {
+	(struct usb_desc_header *)&dfu_usb_desc.if0,
+	(struct usb_desc_header *)&dfu_usb_desc.if0_out_ep,
+	(struct usb_desc_header *)&dfu_usb_desc.if0_in_ep,
+	(struct usb_desc_header *)&dfu_usb_desc.nil_desc,
+};
+
+static const struct usb_desc_header *dfu_usb_hs_desc[] = {
+	(struct usb_desc_header *)&dfu_usb_desc.if0,
+	(struct usb_desc_header *)&dfu_usb_desc.if0_hs_out_ep,
+	(struct usb_desc_header *)&dfu_usb_desc.if0_hs_in_ep,
+	(struct usb_desc_header *)&dfu_usb_desc.nil_desc,
+};
+
+/* One chunk per OUT buffer that can be in flight */
+K_MEM_SLAB_DEFINE_STATIC(dfu_chunk_slab, sizeof(struct dfu_chunk),
+			 CONFIG_RAD_BOOT_DFU_BUF_COUNT, 4);
+
+static struct usbd_class_data *dfu_usb_c_data;
+static atomic_t dfu_usb_state;
+
+static uint8_t dfu_usb_ep_out(struct usbd_class_data *const c_data)
+{
+	struct usbd_context *uds_ctx = usbd_class_get_ctx(c_data);
+
+	if (USBD_SUPPORTS_HIGH_SPEED && usbd_bus_speed(uds_ctx) == USBD_SPEED_HS) {
+		return dfu_usb_desc.if0_hs_out_ep.bEndpointAddress;
+	}
+
+	return dfu_usb_desc.if0_out_ep.bEndpointAddress;
+}
+
+static uint8_t dfu_usb_ep_in(struct usbd_class_data *const c_data)
+{
+	struct usbd_context *uds_ctx = usbd_class_get_ctx(c_data);
+
+	if (USBD_SUPPORTS_HIGH_SPEED && usbd_bus_speed(uds_ctx) == USBD_SPEED_HS) {
+		return dfu_usb_desc.if0_hs_in_ep.bEndpointAddress;
+	}
+
+	return dfu_usb_desc.if0_in_ep.bEndpointAddress;
+}
+
+static int dfu_usb_arm_out(struct usbd_class_data *const c_data)
+{
+	struct net_buf *buf;
+	int err;
+
+	if (!atomic_test_bit(&dfu_usb_state, DFU_USB_ENABLED)) {
+		return -EPERM;
+	}
+
+	buf = usbd_ep_buf_alloc(c_data, dfu_usb_ep_out(c_data), DFU_USB_BUF_SIZE);
+	if (buf == NULL) {
+		LOG_ERR("No buffer for OUT transfer");
+		return -ENOMEM;
+	}
+
+	err = usbd_ep_enqueue(c_data, buf);
+	if (err != 0) {
+		usbd_ep_buf_free(usbd_class_get_ctx(c_data), buf);
+	}
+
+	return err;
+}
+
+static void dfu_usb_respond_data(struct usbd_class_data *const c_data,
+				 const uint8_t cmd, const int err, const uint32_t offset,
+				 const uint8_t *data, const size_t len)
+{
+	struct dfu_pkt_rsp rsp = {
+		.cmd = cmd,
+		.status = (uint8_t)(-err),
+		.window = CONFIG_RAD_BOOT_DFU_BUF_COUNT,
+		.offset = sys_cpu_to_le32(offset),
+	};
+	struct net_buf *buf;
+
+	if (!atomic_test_bit(&dfu_usb_state, DFU_USB_ENABLED)) {
+		return;
+	}
+
+	buf = usbd_ep_buf_alloc(c_data, dfu_usb_ep_in(c_data), sizeof(rsp) + len);
+	if (buf == NULL) {
+		LOG_WRN("No buffer for response to cmd %u", cmd);
+		return;
+	}
+
+	net_buf_add_mem(buf, &rsp, sizeof(rsp));
+	if (len != 0) {
+		net_buf_add_mem(buf, data, len);
+	}
+	if (usbd_ep_enqueue(c_data, buf) != 0) {
+		usbd_ep_buf_free(usbd_class_get_ctx(c_data), buf);
+	}
+}
+
+static void dfu_usb_respond(struct usbd_class_data *const c_data,
+			    const uint8_t cmd, const int err, const uint32_t offset)
+{
+	dfu_usb_respond_data(c_data, cmd, err, offset, NULL, 0);
+}
+
+/* Called by the DFU engine thread once a chunk has been written */
+static void dfu_usb_chunk_done(struct dfu_chunk *chunk, int err)
+{
+	struct usbd_class_data *c_data = dfu_usb_c_data;
+	struct net_buf *buf = chunk->user_data;
+	uint32_t offset = chunk->offset;
+
+	k_mem_slab_free(&dfu_chunk_slab, chunk);
+	usbd_ep_buf_free(usbd_class_get_ctx(c_data), buf);
+
+	dfu_usb_respond(c_data, DFU_CMD_DATA, err, offset);
+	(void)dfu_usb_arm_out(c_data);
+}
+
+/*
+ * Returns true if @p buf was handed over to the DFU engine, which then
+ * frees it and re-arms the endpoint.
+ */
+static bool dfu_usb_handle(struct usbd_class_data *const c_data, struct net_buf *buf)
+{
+	struct dfu_pkt_hdr hdr;
+	struct dfu_chunk *chunk;
+	const uint8_t *map;
+	size_t map_len;
+	uint32_t offset;
+	int err;
+
+	if (buf->len < sizeof(hdr)) {
+		dfu_usb_respond(c_data, 0, -EINVAL, 0);
+		return false;
+	}
+
+	memcpy(&hdr, buf->data, sizeof(hdr));
+	offset = sys_le32_to_cpu(hdr.offset);
+
+	switch (hdr.cmd) {
+	case DFU_CMD_BEGIN:
+		if (sys_le16_to_cpu(hdr.len) != DFU_DIGEST_SIZE ||
+		    buf->len < sizeof(hdr) + DFU_DIGEST_SIZE) {
+			err = -EINVAL;
+			break;
+		}
+
+		switch (hdr.flags & (DFU_FLAG_DELTA | DFU_FLAG_LZ4)) {
+		case 0:
+			err = dfu_engine_begin(offset, buf->data + sizeof(hdr), DFU_FORMAT_RAW);
+			break;
+		case DFU_FLAG_DELTA:
+			err = dfu_engine_begin(offset, buf->data + sizeof(hdr), DFU_FORMAT_DELTA);
+			break;
+		case DFU_FLAG_LZ4:
+			err = dfu_engine_begin(offset, buf->data + sizeof(hdr), DFU_FORMAT_LZ4);
+			break;
+		default:
+			err = -ENOTSUP;
+			break;
+		}
+		break;
+	case DFU_CMD_DATA:
+		if (sys_le16_to_cpu(hdr.len) > CONFIG_RAD_BOOT_DFU_CHUNK_SIZE ||
+		    sys_le16_to_cpu(hdr.len) > buf->len - sizeof(hdr)) {
+			err = -EMSGSIZE;
+			break;
+		}
+
+		if (k_mem_slab_alloc(&dfu_chunk_slab, (void **)&chunk, K_NO_WAIT) != 0) {
+			err = -ENOBUFS;
+			break;
+		}
+
+		chunk->offset = offset;
+		chunk->data = buf->data + sizeof(hdr);
+		chunk->len = sys_le16_to_cpu(hdr.len);
+		chunk->done = dfu_usb_chunk_done;
+		chunk->user_data = buf;
+
+		err = dfu_engine_submit(chunk);
+		if (err == 0) {
+			return true;
+		}
+
+		k_mem_slab_free(&dfu_chunk_slab, chunk);
+		break;
+	case DFU_CMD_END:
+		err = dfu_engine_end(K_MSEC(CONFIG_RAD_BOOT_DFU_END_TIMEOUT_MS));
+		break;
+	case DFU_CMD_ABORT:
+		dfu_engine_abort();
+		err = 0;
+		break;
+	case DFU_CMD_QUERY:
+		map = dfu_engine_resume_map(&map_len);
+		if (map == NULL) {
+			err = -ENODATA;
+			break;
+		}
+
+		dfu_usb_respond_data(c_data, hdr.cmd, 0, CONFIG_RAD_BOOT_DFU_CHUNK_SIZE,
+				     map, map_len);
+		return false;
+	default:
+		err = -ENOTSUP;
+		break;
+	}
+
+	/* BEGIN answers with the address the image has to be linked for */
+	dfu_usb_respond(c_data, hdr.cmd, err,
+			hdr.cmd == DFU_CMD_BEGIN ? image_load_addr(dfu_engine_slot()) : offset);
+
+	return false;
+}
+
+static int dfu_usb_request(struct usbd_class_data *const c_data,
+			   struct net_buf *buf, int err)
+{
+	struct usbd_context *uds_ctx = usbd_class_get_ctx(c_data);
+	struct udc_buf_info *bi = udc_get_buf_info(buf);
+
+	if (USB_EP_DIR_IS_IN(bi->ep)) {
+		const struct dfu_pkt_rsp *rsp = (const struct dfu_pkt_rsp *)buf->data;
+
+		/* The session is over once the host has the final status */
+		if (err == 0 && rsp->cmd == DFU_CMD_END && rsp->status == 0) {
+			dfu_engine_notify(DFU_NOTIFY_DONE);
+		}
+
+		usbd_ep_buf_free(uds_ctx, buf);
+		return 0;
+	}
+
+	if (err != 0) {
+		if (err != -ECONNABORTED) {
+			LOG_WRN("OUT transfer failed, %d", err);
+		}
+
+		usbd_ep_buf_free(uds_ctx, buf);
+		return 0;
+	}
+
+	if (!dfu_usb_handle(c_data, buf)) {
+		usbd_ep_buf_free(uds_ctx, buf);
+		(void)dfu_usb_arm_out(c_data);
+	}
+
+	return 0;
+}
+
+static void dfu_usb_enable(struct usbd_class_data *const c_data)
+{
+	if (atomic_test_and_set_bit(&dfu_usb_state, DFU_USB_ENABLED)) {
+		return;
+	}
+
+	for (int i = 0; i < CONFIG_RAD_BOOT_DFU_BUF_COUNT; i++) {
+		if (dfu_usb_arm_out(c_data) != 0) {
+			break;
+		}
+	}
+}
+
+static void dfu_usb_disable(struct usbd_class_data *const c_data)
+{
+	atomic_clear_bit(&dfu_usb_state, DFU_USB_ENABLED);
+	dfu_engine_abort();
+}
+
+static void *dfu_usb_get_desc(struct usbd_class_data *const c_data,
+			      const enum usbd_speed speed)
+{
+	if (USBD_SUPPORTS_HIGH_SPEED && speed == USBD_SPEED_HS) {
+		return dfu_usb_hs_desc;
+	}
+
+	return dfu_usb_fs_desc;
+}
+
+static int dfu_usb_init(struct usbd_class_data *const c_data)
+{
+	dfu_usb_c_data = c_data;
+
+	return 0;
+}
+
+static struct usbd_class_api dfu_usb_api = {
+	.request = dfu_usb_request,
+	.enable = dfu_usb_enable,
+	.disable = dfu_usb_disable,
+	.init = dfu_usb_init,
+	.get_desc = dfu_usb_get_desc,
+};
+
+USBD_DEFINE_CLASS(rad_dfu, &dfu_usb_api, NULL, NULL);
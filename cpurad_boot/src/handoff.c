@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <boot_retained.h>
+#include <handoff.h>
+#include <image.h>
+
+static const char *const boot_reason_str[] = {
+	[BOOT_REASON_COLD] = "cold",
+	[BOOT_REASON_RESET] = "reset",
+	[BOOT_REASON_UPDATE] = "update",
+	[BOOT_REASON_ROLLBACK] = "rollback",
+};
+
+static struct boot_handoff handoff_prev;
+static bool handoff_prev_valid;
+static struct boot_handoff handoff_next;
+static bool handoff_ready;
+
+void handoff_init(void)
+{
+	handoff_prev_valid = boot_handoff_load(&handoff_prev);
+}
+
+const struct boot_handoff *handoff_previous(void)
+{
+	return handoff_prev_valid ? &handoff_prev : NULL;
+}
+
+void handoff_prepare(enum image_slot slot, enum boot_dfu_reason dfu_reason, bool installed)
+{
+	const struct image_header *hdr = image_header_get(slot);
+	struct boot_handoff *h = &handoff_next;
+	int cmp;
+
+	memset(h, 0, sizeof(*h));
+	h->magic = BOOT_HANDOFF_MAGIC;
+	h->version = BOOT_HANDOFF_VERSION;
+	h->size = sizeof(*h);
+	h->dfu_reason = dfu_reason;
+	h->slot = slot;
+	h->verify = image_verified_by(slot);
+
+	BUILD_ASSERT(sizeof(h->image) == sizeof(hdr->version),
+		     "boot_handoff_version does not match image_version");
+	if (hdr != NULL) {
+		memcpy(&h->image, &hdr->version, sizeof(h->image));
+	}
+
+	if (installed) {
+		h->reason = BOOT_REASON_UPDATE;
+	} else if (!handoff_prev_valid) {
+		h->reason = BOOT_REASON_COLD;
+	} else {
+		cmp = image_version_cmp((const struct image_version *)&h->image,
+					(const struct image_version *)&handoff_prev.image);
+		h->reason = cmp > 0 ? BOOT_REASON_UPDATE :
+			    cmp < 0 ? BOOT_REASON_ROLLBACK : BOOT_REASON_RESET;
+	}
+
+	printk("[handoff] %s boot of slot %u, v%u.%u.%u+%u\n", boot_reason_str[h->reason],
+	       h->slot, h->image.major, h->image.minor, h->image.revision, h->image.build);
+
+	handoff_ready = true;
+}
+
+void handoff_seal(void)
+{
+	volatile uint8_t *dst = (volatile uint8_t *)&boot_retained->handoff;
+	const uint8_t *src = (const uint8_t *)&handoff_next;
+
+	if (!handoff_ready) {
+		return;
+	}
+
+	handoff_next.timeline_crc = boot_timeline_crc();
+	handoff_next.crc = boot_handoff_crc(&handoff_next);
+
+	for (size_t i = 0; i < sizeof(handoff_next); i++) {
+		dst[i] = src[i];
+	}
+}
@@ -0,0 +1,423 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/printk.h>
+#include <psa/crypto.h>
+#include <image.h>
+#include <mram.h>
+#include <timeline.h>
+
+#ifdef CONFIG_ZTEST
+/* Set by image_test_map() */
+static uint32_t image_mram_base;
+#define MRAM_BASE               image_mram_base
+#else
+#define MRAM_BASE               DT_REG_ADDR(DT_NODELABEL(mram1x))
+#endif
+#define CACHE_PARTITION_ID      FIXED_PARTITION_ID(boot_cache_partition)
+
+#ifdef CONFIG_RAD_BOOT_STAGE0
+#define STAGE1_NODE             DT_NODELABEL(cpurad_stage1_partition)
+#define STAGE1_ADDR             (MRAM_BASE + DT_REG_ADDR(STAGE1_NODE))
+#define STAGE1_SIZE             DT_REG_SIZE(STAGE1_NODE)
+#endif
+
+#define IMAGE_CACHE_MAGIC       0x48434952 /* "RICH" */
+#define IMAGE_CACHE_VALID       0x56414C44 /* "VALD" */
+#define IMAGE_CACHE_INVALID     0x42414444 /* "BADD" */
+#define IMAGE_CACHE_UNSIGNED    0x4E474953 /* "SIGN" */
+
+/* One record per slot in boot_cache_partition, a multiple of the MRAM
+ * write block so each record is written in one go.
+ */
+struct image_cache_rec {
+	uint32_t magic;
+	uint32_t img_size;
+	uint32_t result;
+	uint32_t crc;
+	uint8_t hdr_hash[IMAGE_HASH_SIZE];
+};
+
+BUILD_ASSERT(sizeof(struct image_cache_rec) % 16 == 0,
+	     "image_cache_rec must be a multiple of the MRAM write block");
+
+/* Offsets from MRAM_BASE */
+static const struct {
+	uint32_t offset;
+	uint32_t size;
+	uint8_t fa_id;
+} image_slots[IMAGE_SLOT_COUNT] = {
+	[IMAGE_SLOT_PRIMARY] = {
+		.offset = DT_REG_ADDR(DT_NODELABEL(cpurad_app_partition)),
+		.size = DT_REG_SIZE(DT_NODELABEL(cpurad_app_partition)),
+		.fa_id = FIXED_PARTITION_ID(cpurad_app_partition),
+	},
+	[IMAGE_SLOT_SECONDARY] = {
+		.offset = DT_REG_ADDR(DT_NODELABEL(cpurad_app2_partition)),
+		.size = DT_REG_SIZE(DT_NODELABEL(cpurad_app2_partition)),
+		.fa_id = FIXED_PARTITION_ID(cpurad_app2_partition),
+	},
+};
+
+static const char *const slot_names[IMAGE_SLOT_COUNT] = {
+	[IMAGE_SLOT_PRIMARY] = "slot 0",
+	[IMAGE_SLOT_SECONDARY] = "slot 1",
+};
+
+static enum boot_verify image_verified[IMAGE_SLOT_COUNT];
+
+#ifdef CONFIG_RAD_BOOT_SIGNATURE
+/* Uncompressed P-256 point, generated from CONFIG_RAD_BOOT_SIGNATURE_KEY */
+static const uint8_t image_pubkey[] = {
+#include "rad_pubkey.inc"
+};
+
+static psa_key_id_t image_key_id;
+#endif
+
+uint32_t image_slot_addr(enum image_slot slot)
+{
+	return MRAM_BASE + image_slots[slot].offset;
+}
+
+uint32_t image_slot_size(enum image_slot slot)
+{
+	return image_slots[slot].size;
+}
+
+uint8_t image_slot_fa_id(enum image_slot slot)
+{
+	return image_slots[slot].fa_id;
+}
+
+uint32_t image_load_addr(enum image_slot slot)
+{
+	return image_slot_addr(IS_ENABLED(CONFIG_RAD_BOOT_XIP_AB) ? slot : IMAGE_SLOT_PRIMARY);
+}
+
+int image_version_cmp(const struct image_version *a, const struct image_version *b)
+{
+	if (a->major != b->major) {
+		return a->major - b->major;
+	}
+
+	if (a->minor != b->minor) {
+		return a->minor - b->minor;
+	}
+
+	if (a->revision != b->revision) {
+		return a->revision - b->revision;
+	}
+
+	return (a->build > b->build) - (a->build < b->build);
+}
+
+static const struct image_header *image_header_at(uint32_t addr, uint32_t size)
+{
+	const struct image_header *hdr = (const struct image_header *)addr;
+
+	if (hdr->magic != IMAGE_MAGIC ||
+	    hdr->hdr_size < sizeof(*hdr) ||
+	    hdr->img_size == 0 ||
+	    (uint64_t)hdr->hdr_size + hdr->img_size > size) {
+		return NULL;
+	}
+
+	return hdr;
+}
+
+const struct image_header *image_header_get(enum image_slot slot)
+{
+	return image_header_at(image_slot_addr(slot), image_slots[slot].size);
+}
+
+uint32_t image_entry(enum image_slot slot)
+{
+	const struct image_header *hdr = image_header_get(slot);
+
+	return image_slot_addr(slot) + (hdr != NULL ? hdr->hdr_size : 0);
+}
+
+static int image_sha256(const void *data, size_t len, uint8_t out[IMAGE_HASH_SIZE])
+{
+	size_t out_len;
+
+	if (psa_hash_compute(PSA_ALG_SHA_256, data, len, out, IMAGE_HASH_SIZE,
+			     &out_len) != PSA_SUCCESS) {
+		return -EIO;
+	}
+
+	return 0;
+}
+
+/* Key for the verified-image cache: the header, its signature and the key
+ * it has to be signed with, so none of them can change under a record
+ */
+static int image_hdr_hash(const struct image_header *hdr, uint8_t out[IMAGE_HASH_SIZE])
+{
+	psa_hash_operation_t op = PSA_HASH_OPERATION_INIT;
+	psa_status_t status;
+	size_t out_len;
+
+	if (!IS_ENABLED(CONFIG_RAD_BOOT_SIGNATURE)) {
+		return image_sha256(hdr, sizeof(*hdr), out);
+	}
+
+	status = psa_hash_setup(&op, PSA_ALG_SHA_256);
+	if (status == PSA_SUCCESS) {
+		status = psa_hash_update(&op, (const uint8_t *)hdr, sizeof(*hdr));
+	}
+#ifdef CONFIG_RAD_BOOT_SIGNATURE
+	if (status == PSA_SUCCESS && (hdr->flags & IMAGE_F_SIGNED) &&
+	    hdr->hdr_size >= sizeof(*hdr) + IMAGE_SIG_SIZE) {
+		status = psa_hash_update(&op, (const uint8_t *)(hdr + 1), IMAGE_SIG_SIZE);
+	}
+	if (status == PSA_SUCCESS) {
+		status = psa_hash_update(&op, image_pubkey, sizeof(image_pubkey));
+	}
+#endif
+	if (status == PSA_SUCCESS) {
+		status = psa_hash_finish(&op, out, IMAGE_HASH_SIZE, &out_len);
+	}
+
+	if (status != PSA_SUCCESS) {
+		psa_hash_abort(&op);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+#ifdef CONFIG_RAD_BOOT_SIGNATURE
+static int image_sig_verify(const struct image_header *hdr)
+{
+	psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+
+	if (!(hdr->flags & IMAGE_F_SIGNED) ||
+	    hdr->hdr_size < sizeof(*hdr) + IMAGE_SIG_SIZE) {
+		return -EPERM;
+	}
+
+	if (image_key_id == PSA_KEY_ID_NULL) {
+		psa_set_key_type(&attr, PSA_KEY_TYPE_ECC_PUBLIC_KEY(PSA_ECC_FAMILY_SECP_R1));
+		psa_set_key_bits(&attr, 256);
+		psa_set_key_usage_flags(&attr, PSA_KEY_USAGE_VERIFY_MESSAGE);
+		psa_set_key_algorithm(&attr, PSA_ALG_ECDSA(PSA_ALG_SHA_256));
+
+		if (psa_import_key(&attr, image_pubkey, sizeof(image_pubkey),
+				   &image_key_id) != PSA_SUCCESS) {
+			image_key_id = PSA_KEY_ID_NULL;
+			return -EIO;
+		}
+	}
+
+	/* The header holds the image digest, signing it covers the image */
+	if (psa_verify_message(image_key_id, PSA_ALG_ECDSA(PSA_ALG_SHA_256),
+			       (const uint8_t *)hdr, sizeof(*hdr),
+			       (const uint8_t *)(hdr + 1), IMAGE_SIG_SIZE) != PSA_SUCCESS) {
+		return -EPERM;
+	}
+
+	return 0;
+}
+#endif
+
+/* Digest and, with CONFIG_RAD_BOOT_SIGNATURE, signature check of a memory
+ * mapped image. @p name only labels the printed timings.
+ */
+static int image_check(const struct image_header *hdr, const char *name)
+{
+	uint8_t digest[IMAGE_HASH_SIZE];
+	uint32_t start = timeline_now();
+	int err;
+
+	/* The image is memory mapped, hash it in place */
+	err = image_sha256((const uint8_t *)hdr + hdr->hdr_size, hdr->img_size, digest);
+	if (err != 0) {
+		return err;
+	}
+
+	err = memcmp(digest, hdr->sha256, sizeof(digest)) == 0 ? 0 : -EBADMSG;
+
+	printk("[image] %s full verify of %u bytes: %u us (%s)\n", name,
+	       hdr->img_size, timeline_cyc_to_us(timeline_now() - start),
+	       err == 0 ? "ok" : "bad digest");
+
+#ifdef CONFIG_RAD_BOOT_SIGNATURE
+	if (err == 0) {
+		start = timeline_now();
+		err = image_sig_verify(hdr);
+		printk("[image] %s signature verify: %u us (%s)\n", name,
+		       timeline_cyc_to_us(timeline_now() - start),
+		       err == 0 ? "ok" : err == -EPERM ? "bad signature" : "error");
+	}
+#endif
+
+	return err;
+}
+
+static uint32_t image_cache_crc(const struct image_cache_rec *rec)
+{
+	return crc32_ieee((const uint8_t *)rec, offsetof(struct image_cache_rec, crc)) ^
+	       crc32_ieee(rec->hdr_hash, sizeof(rec->hdr_hash));
+}
+
+static int image_cache_write(enum image_slot slot, const struct image_cache_rec *rec)
+{
+	const struct flash_area *fa;
+	int err;
+
+	if (!IS_ENABLED(CONFIG_RAD_BOOT_IMAGE_CACHE)) {
+		return 0;
+	}
+
+	err = flash_area_open(CACHE_PARTITION_ID, &fa);
+	if (err != 0) {
+		return err;
+	}
+
+	err = mram_write(fa, slot * sizeof(*rec), rec, sizeof(*rec));
+	flash_area_close(fa);
+
+	return err;
+}
+
+static bool image_cache_read(enum image_slot slot, struct image_cache_rec *rec)
+{
+	const struct flash_area *fa;
+	int err;
+
+	if (!IS_ENABLED(CONFIG_RAD_BOOT_IMAGE_CACHE)) {
+		return false;
+	}
+
+	err = flash_area_open(CACHE_PARTITION_ID, &fa);
+	if (err != 0) {
+		return false;
+	}
+
+	err = flash_area_read(fa, slot * sizeof(*rec), rec, sizeof(*rec));
+	flash_area_close(fa);
+
+	return err == 0 && rec->magic == IMAGE_CACHE_MAGIC &&
+	       rec->crc == image_cache_crc(rec);
+}
+
+enum boot_verify image_verified_by(enum image_slot slot)
+{
+	return image_verified[slot];
+}
+
+void image_cache_invalidate(enum image_slot slot)
+{
+	struct image_cache_rec rec = { 0 };
+
+	(void)image_cache_write(slot, &rec);
+}
+
+int image_validate(enum image_slot slot)
+{
+	const struct image_header *hdr = image_header_get(slot);
+	struct image_cache_rec rec;
+	uint8_t hdr_hash[IMAGE_HASH_SIZE];
+	uint32_t start = timeline_now();
+	int err;
+
+	image_verified[slot] = BOOT_VERIFY_NONE;
+
+	if (hdr == NULL) {
+		return -ENOENT;
+	}
+
+	if (hdr->load_addr != image_load_addr(slot)) {
+		return -ENOEXEC;
+	}
+
+	if (psa_crypto_init() != PSA_SUCCESS) {
+		return -EIO;
+	}
+
+	/* O(1): only the header is hashed to look the slot up in the cache */
+	err = image_hdr_hash(hdr, hdr_hash);
+	if (err != 0) {
+		return err;
+	}
+
+	if (image_cache_read(slot, &rec) &&
+	    rec.img_size == hdr->img_size &&
+	    memcmp(rec.hdr_hash, hdr_hash, sizeof(hdr_hash)) == 0) {
+		printk("[image] slot %d cached verify: %u us\n", slot,
+		       timeline_cyc_to_us(timeline_now() - start));
+		if (rec.result != IMAGE_CACHE_VALID) {
+			return rec.result == IMAGE_CACHE_UNSIGNED ? -EPERM : -EBADMSG;
+		}
+
+		image_verified[slot] = BOOT_VERIFY_CACHED;
+		return 0;
+	}
+
+	err = image_check(hdr, slot_names[slot]);
+	if (err == -EIO) {
+		/* Not a verdict on the image, keep it out of the cache */
+		return err;
+	}
+
+	if (err == 0) {
+		image_verified[slot] = BOOT_VERIFY_DIGEST;
+	}
+
+	rec.magic = IMAGE_CACHE_MAGIC;
+	rec.img_size = hdr->img_size;
+	rec.result = (err == 0) ? IMAGE_CACHE_VALID :
+		     (err == -EPERM) ? IMAGE_CACHE_UNSIGNED : IMAGE_CACHE_INVALID;
+	memcpy(rec.hdr_hash, hdr_hash, sizeof(hdr_hash));
+	rec.crc = image_cache_crc(&rec);
+
+	if (image_cache_write(slot, &rec) != 0) {
+		printk("[image] slot %d cache update failed\n", slot);
+	}
+
+	return err;
+}
+
+#ifdef CONFIG_RAD_BOOT_STAGE0
+int image_validate_stage1(void)
+{
+	const struct image_header *hdr = image_header_at(STAGE1_ADDR, STAGE1_SIZE);
+
+	if (hdr == NULL) {
+		return -ENOENT;
+	}
+
+	if (hdr->load_addr != STAGE1_ADDR) {
+		return -ENOEXEC;
+	}
+
+	if (psa_crypto_init() != PSA_SUCCESS) {
+		return -EIO;
+	}
+
+	/* Only started for DFU, not worth a cache record */
+	return image_check(hdr, "stage-1");
+}
+
+uint32_t image_stage1_entry(void)
+{
+	return STAGE1_ADDR + ((const struct image_header *)STAGE1_ADDR)->hdr_size;
+}
+#endif
+
+#ifdef CONFIG_ZTEST
+void image_test_map(const void *mram)
+{
+	image_mram_base = (uint32_t)(uintptr_t)mram;
+}
+#endif
@@ -21,14 +21,30 @@
 #include <zephyr/usb/usbd.h>
 #include <zephyr/usb/class/usbd_hid.h>
 #include <sample_usbd.h>
+#include <boot_retained.h>
+#include <hid_stats.h>
+#include <timeline.h>
+#include <dfu_engine.h>
+#include <dfu_hid.h>
+#include <dfu_proto.h>
+#include <handoff.h>
+#include <image.h>
+#include <rollback.h>
+#include <swap.h>
 /* Macro----------------------------------------------------------------------*/
 #define LOG_MODULE_NAME boot
 LOG_MODULE_REGISTER(LOG_MODULE_NAME);
 
 
-#define MRAM_NODE               DT_NODELABEL(mram1x)
-#define APP_PARTITION_NODE      DT_NODELABEL(cpurad_app_partition)
-#define TARGET_IMAGE_ADDRESS    (DT_REG_ADDR(MRAM_NODE) + DT_REG_ADDR(APP_PARTITION_NODE))
+#define SRAM_NODE               DT_CHOSEN(zephyr_sram)
+#define SRAM_START              DT_REG_ADDR(SRAM_NODE)
+#define SRAM_END                (SRAM_START + DT_REG_SIZE(SRAM_NODE))
+
+#ifdef CONFIG_RAD_BOOT_STAGE0
+#define STAGE1_NODE             DT_NODELABEL(cpurad_stage1_partition)
+#define STAGE1_ADDR             (DT_REG_ADDR(DT_NODELABEL(mram1x)) + DT_REG_ADDR(STAGE1_NODE))
+#define STAGE1_SIZE             DT_REG_SIZE(STAGE1_NODE)
+#endif
 
 #define TEST_PIN_1 NRF_GPIO_PIN_MAP(9,0)/* MC : pin 9.0 */
 #define TEST_PIN_2 NRF_GPIO_PIN_MAP(0,8)/* MC : pin 0.8 */
@@ -44,10 +60,29 @@ typedef struct arm_vector_table_s
 
 /* Private function prototypes------------------------------------------------*/
 static void __attribute__((noreturn)) jump_to_image(uint32_t image_addr);
+static bool vector_table_check(uint32_t image_addr, uint32_t slot_end);
+static bool vector_table_is_valid(enum image_slot slot);
+#ifdef CONFIG_RAD_BOOT_STAGE0
+static void stage1_start(void);
+#endif
+#ifdef CONFIG_RAD_BOOT_ROLLBACK
+static void rollback_confirm_take(void);
+#endif
+static int boot_slot_select(void);
+#ifdef CONFIG_RAD_BOOT_DFU
+static void dfu_slot_update(int boot_slot);
+#endif
+static enum boot_dfu_reason dfu_reason_get(bool app_valid);
 
 /* Global variables ----------------------------------------------------------*/
 
 /* Private variables ---------------------------------------------------------*/
+static const char *const dfu_reason_str[] = {
+	[BOOT_DFU_NONE] = "none",
+	[BOOT_DFU_STRAP] = "strap",
+	[BOOT_DFU_REQUESTED] = "request",
+	[BOOT_DFU_NO_IMAGE] = "no valid image",
+};
 
 /* Macro ---------------------------------------------------------------------*/
 
@@ -55,21 +90,92 @@ static void __attribute__((noreturn)) jump_to_image(uint32_t image_addr);
 
 #ifdef CONFIG_USB_DEVICE_STACK_NEXT
 // static const struct gpio_dt_spec led0 = GPIO_DT_SPEC_GET(DT_ALIAS(led0), gpios);
-static const uint8_t hid_report_desc[] = HID_MOUSE_REPORT_DESC(2);
+#define MOUSE_REPORT_ID		1
+
+/* HID_MOUSE_REPORT_DESC(2) with a report ID, followed by a vendor defined
+ * collection carrying DFU packets, see dfu_proto.h, and the input
+ * statistics collection, see hid_stats.h.
+ */
+static const uint8_t hid_report_desc[] = {
+	HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
+	HID_USAGE(HID_USAGE_GEN_DESKTOP_MOUSE),
+	HID_COLLECTION(HID_COLLECTION_APPLICATION),
+		HID_REPORT_ID(MOUSE_REPORT_ID),
+		HID_USAGE(HID_USAGE_GEN_DESKTOP_POINTER),
+		HID_COLLECTION(HID_COLLECTION_PHYSICAL),
+			HID_USAGE_PAGE(HID_USAGE_GEN_BUTTON),
+			HID_USAGE_MIN8(1),
+			HID_USAGE_MAX8(2),
+			HID_LOGICAL_MIN8(0),
+			HID_LOGICAL_MAX8(1),
+			HID_REPORT_SIZE(1),
+			HID_REPORT_COUNT(2),
+			HID_INPUT(0x02),
+			HID_REPORT_SIZE(6),
+			HID_REPORT_COUNT(1),
+			HID_INPUT(0x01),
+			HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
+			HID_USAGE(HID_USAGE_GEN_DESKTOP_X),
+			HID_USAGE(HID_USAGE_GEN_DESKTOP_Y),
+			HID_USAGE(HID_USAGE_GEN_DESKTOP_WHEEL),
+			HID_LOGICAL_MIN8(-127),
+			HID_LOGICAL_MAX8(127),
+			HID_REPORT_SIZE(8),
+			HID_REPORT_COUNT(3),
+			HID_INPUT(0x06),
+		HID_END_COLLECTION,
+	HID_END_COLLECTION,
+#ifdef CONFIG_RAD_BOOT_DFU_HID
+
+	/* Usage Page (Vendor Defined 0xFF00) */
+	HID_ITEM(HID_ITEM_TAG_USAGE_PAGE, HID_ITEM_TYPE_GLOBAL, 2), 0x00, 0xFF,
+	HID_USAGE(0x01),
+	HID_COLLECTION(HID_COLLECTION_APPLICATION),
+		HID_LOGICAL_MIN8(0),
+		HID_LOGICAL_MAX16(0xFF, 0x00),
+		HID_REPORT_SIZE(8),
+		HID_REPORT_ID(DFU_HID_DATA_REPORT_ID),
+		HID_USAGE(0x02),
+		HID_ITEM(HID_ITEM_TAG_REPORT_COUNT, HID_ITEM_TYPE_GLOBAL, 2),
+			DFU_HID_DATA_SIZE & 0xFF, DFU_HID_DATA_SIZE >> 8,
+		HID_OUTPUT(0x02),
+		HID_REPORT_ID(DFU_HID_STATUS_REPORT_ID),
+		HID_USAGE(0x03),
+		HID_ITEM(HID_ITEM_TAG_REPORT_COUNT, HID_ITEM_TYPE_GLOBAL, 2),
+			sizeof(struct dfu_hid_status) & 0xFF, sizeof(struct dfu_hid_status) >> 8,
+		HID_FEATURE(0x02),
+	HID_END_COLLECTION,
+#endif
+
+	HID_STATS_REPORT_DESC(),
+};
 
 #define MOUSE_BTN_LEFT		0
 #define MOUSE_BTN_RIGHT		1
 
 enum mouse_report_idx {
-	MOUSE_BTN_REPORT_IDX = 0,
-	MOUSE_X_REPORT_IDX = 1,
-	MOUSE_Y_REPORT_IDX = 2,
-	MOUSE_WHEEL_REPORT_IDX = 3,
-	MOUSE_REPORT_COUNT = 4,
+	MOUSE_ID_REPORT_IDX = 0,
+	MOUSE_BTN_REPORT_IDX = 1,
+	MOUSE_X_REPORT_IDX = 2,
+	MOUSE_Y_REPORT_IDX = 3,
+	MOUSE_WHEEL_REPORT_IDX = 4,
+	MOUSE_REPORT_COUNT = 5,
 };
 
+/* USB state changes the boot flow waits on instead of sleeping */
+#define USB_EVT_VBUS_READY      BIT(0)
+#define USB_EVT_VBUS_REMOVED    BIT(1)
+#define USB_EVT_CONFIGURED      BIT(2)
+#define USB_EVT_IFACE_DOWN      BIT(3)
+#define USB_EVT_DFU_ACTIVITY    BIT(4)
+#define USB_EVT_DFU_DONE        BIT(5)
+
 // K_MSGQ_DEFINE(mouse_msgq, MOUSE_REPORT_COUNT, 2, 1);
 static bool mouse_ready;
+/* The bootloader sends no mouse reports, only the USB counters move */
+static struct hid_stats mouse_stats;
+static bool usb_started;
+static K_EVENT_DEFINE(usb_events);
 struct usbd_context *sample_usbd;
 const struct device *hid_dev;
 // static void input_cb(struct input_event *evt, void *user_data)
@@ -119,22 +225,97 @@ static void mouse_iface_ready(const struct device *dev, const bool ready)
 	printk("HID device %s interface is %s\n",
 		dev->name, ready ? "ready" : "not ready");
 	mouse_ready = ready;
+
+	if (ready) {
+		mouse_stats.ready_up++;
+		k_event_clear(&usb_events, USB_EVT_IFACE_DOWN);
+	} else {
+		mouse_stats.ready_down++;
+#ifdef CONFIG_RAD_BOOT_DFU_HID
+		dfu_hid_disable();
+#endif
+		k_event_post(&usb_events, USB_EVT_IFACE_DOWN);
+	}
 }
 
 static int mouse_get_report(const struct device *dev,
 			 const uint8_t type, const uint8_t id, const uint16_t len,
 			 uint8_t *const buf)
 {
+#ifdef CONFIG_RAD_BOOT_DFU_HID
+	if (type == HID_REPORT_TYPE_FEATURE && id == DFU_HID_STATUS_REPORT_ID) {
+		return dfu_hid_status_get(buf, len);
+	}
+#endif
+	if (type == HID_REPORT_TYPE_FEATURE && id == HID_STATS_REPORT_ID) {
+		return hid_stats_report(&mouse_stats, buf, len);
+	}
+
 	printk("Get Report not implemented, Type %u ID %u\n", type, id);
 
 	return 0;
 }
 
+#ifdef CONFIG_RAD_BOOT_DFU_HID
+static void mouse_output_report(const struct device *dev, const uint16_t len,
+				const uint8_t *const buf)
+{
+	dfu_hid_output(buf, len);
+}
+#endif
+
 struct hid_device_ops mouse_ops = {
 	.iface_ready = mouse_iface_ready,
 	.get_report = mouse_get_report,
+#ifdef CONFIG_RAD_BOOT_DFU_HID
+	.output_report = mouse_output_report,
+#endif
 };
 
+#ifdef CONFIG_RAD_BOOT_DFU
+static void dfu_notify_cb(enum dfu_notify evt)
+{
+	switch (evt) {
+	case DFU_NOTIFY_ACTIVITY:
+		k_event_post(&usb_events, USB_EVT_DFU_ACTIVITY);
+		break;
+	case DFU_NOTIFY_DONE:
+		k_event_post(&usb_events, USB_EVT_DFU_DONE);
+		break;
+	case DFU_NOTIFY_ERROR:
+		LOG_PRINTK("DFU session failed\n");
+		break;
+	}
+}
+#endif
+
+static void usbd_msg_cb(struct usbd_context *const usbd_ctx,
+			const struct usbd_msg *const msg)
+{
+	switch (msg->type) {
+	case USBD_MSG_VBUS_READY:
+		k_event_clear(&usb_events, USB_EVT_VBUS_REMOVED);
+		if (usbd_can_detect_vbus(usbd_ctx) && usbd_enable(usbd_ctx) != 0) {
+			printk("Failed to enable device support\n");
+			break;
+		}
+		k_event_post(&usb_events, USB_EVT_VBUS_READY);
+		break;
+	case USBD_MSG_VBUS_REMOVED:
+		k_event_clear(&usb_events, USB_EVT_VBUS_READY | USB_EVT_CONFIGURED);
+		if (usbd_can_detect_vbus(usbd_ctx)) {
+			(void)usbd_disable(usbd_ctx);
+		}
+		k_event_post(&usb_events, USB_EVT_VBUS_REMOVED);
+		break;
+	case USBD_MSG_CONFIGURATION:
+		k_event_post(&usb_events, USB_EVT_CONFIGURED);
+		break;
+	default:
+		break;
+	}
+}
+
 int hsusb_init(void)
 {
 
@@ -151,6 +332,8 @@ int hsusb_init(void)
 	// 	return 0;
 	// }
 
+	hid_stats_init(&mouse_stats, SystemCoreClock);
+
 	hid_dev = DEVICE_DT_GET_ONE(zephyr_hid_device);
 	if (!device_is_ready(hid_dev)) {
 		printk("HID Device is not ready\n");
@@ -165,22 +348,84 @@ int hsusb_init(void)
 		return ret;
 	}
 
-	sample_usbd = sample_usbd_init_device(NULL);
+	k_event_post(&usb_events, USB_EVT_IFACE_DOWN);
+
+#ifdef CONFIG_RAD_BOOT_DFU
+	dfu_engine_init(dfu_notify_cb);
+#endif
+
+	sample_usbd = sample_usbd_init_device(usbd_msg_cb);
 	if (sample_usbd == NULL) {
 		printk("Failed to initialize USB device\n");
 		return -ENODEV;
 	}
 
-	ret = usbd_enable(sample_usbd);
-	if (ret != 0) {
-		printk("Failed to enable device support\n");
-		return ret;
+	usb_started = true;
+
+	/* Without VBUS detection the controller is enabled right away and the
+	 * bus is assumed to be powered, otherwise usbd_msg_cb() enables it.
+	 */
+	if (!usbd_can_detect_vbus(sample_usbd)) {
+		ret = usbd_enable(sample_usbd);
+		if (ret != 0) {
+			printk("Failed to enable device support\n");
+			return ret;
+		}
+
+		k_event_post(&usb_events, USB_EVT_VBUS_READY);
 	}
 
 	printk("USB device support enabled\n");
 
 	return 0;
 }
+
+/**
+ * @brief Run one USB DFU session
+ *
+ * Every step ends on a USB event or its timeout. With no valid application
+ * to fall back to, the session waits forever for the host.
+ *
+ * @param app_valid true if the application image can be started
+ *
+ * @return true if an image was received
+ */
+static bool dfu_session(bool app_valid)
+{
+	uint32_t events;
+
+	events = k_event_wait(&usb_events, USB_EVT_VBUS_READY, false,
+			      app_valid ? K_MSEC(CONFIG_RAD_BOOT_VBUS_TIMEOUT_MS) : K_FOREVER);
+	if (events == 0) {
+		LOG_PRINTK("No VBUS, leaving DFU mode\n");
+		return false;
+	}
+
+	events = k_event_wait(&usb_events, USB_EVT_CONFIGURED | USB_EVT_VBUS_REMOVED, false,
+			      app_valid ? K_MSEC(CONFIG_RAD_BOOT_ENUM_TIMEOUT_MS) : K_FOREVER);
+	if (!(events & USB_EVT_CONFIGURED)) {
+		LOG_PRINTK("Not configured by host, leaving DFU mode\n");
+		return false;
+	}
+
+	/* The session ends when the host goes away, an image has been received
+	 * or no DFU traffic was seen for the idle timeout.
+	 */
+	do {
+		events = k_event_wait(&usb_events, USB_EVT_VBUS_REMOVED |
+				      USB_EVT_DFU_ACTIVITY | USB_EVT_DFU_DONE, false,
+				      app_valid ? K_MSEC(CONFIG_RAD_BOOT_DFU_IDLE_TIMEOUT_MS) :
+						  K_FOREVER);
+		k_event_clear(&usb_events, USB_EVT_DFU_ACTIVITY | USB_EVT_DFU_DONE);
+	} while (events == USB_EVT_DFU_ACTIVITY);
+
+	if (events & USB_EVT_DFU_DONE) {
+		LOG_PRINTK("Image received\n");
+		return true;
+	}
+
+	return false;
+}
 #endif
 
 int main(void)
@@ -190,24 +435,67 @@ int main(void)
     LOG_PRINTK("****************************************\n");
     nrf_gpio_cfg_output(TEST_PIN_1);
     nrf_gpio_pin_set(TEST_PIN_1); /* MC : set pin high to indicate bootloader is running */
-    
-    /* Configure P0.08 as input and check its level */
-    nrf_gpio_cfg_input(TEST_PIN_2, NRF_GPIO_PIN_NOPULL);
-    uint32_t pin_level = nrf_gpio_pin_read(TEST_PIN_2);
-    if (pin_level) {
-        LOG_PRINTK("P0.08 is HIGH\n");
-    } else {
-        LOG_PRINTK("P0.08 is LOW\n");
-    }
-    
+    timeline_mark(BOOT_TL_MAIN);
+    handoff_init();
+#ifdef CONFIG_RAD_BOOT_ROLLBACK
+    rollback_confirm_take();
+#endif
+
+    /* Set once a new image is received or swapped in */
+    bool installed = false;
+
+#ifdef CONFIG_RAD_BOOT_SWAP
+    /* Finishes a swap interrupted by a reset before anything is validated */
+    installed = (swap_install() == 0);
+#endif
+
+    int slot = boot_slot_select();
+    enum boot_dfu_reason reason = dfu_reason_get(slot >= 0);
+
+    LOG_PRINTK("DFU reason: %s\n", dfu_reason_str[reason]);
+    timeline_mark(BOOT_TL_DECISION);
+
+#ifdef CONFIG_RAD_BOOT_DFU
+    dfu_slot_update(slot);
+#endif
+
+#ifdef CONFIG_RAD_BOOT_DFU_BENCH
+    dfu_bench_run();
+#endif
+
     //customer code put here
+#ifdef CONFIG_RAD_BOOT_STAGE0
+    if (reason != BOOT_DFU_NONE || !IS_ENABLED(CONFIG_RAD_BOOT_FAST_BOOT)) {
+        stage1_start();
+    }
+#endif
 #ifdef CONFIG_USB_DEVICE_STACK_NEXT
-    hsusb_init();
-    k_msleep(5000);
+    if (reason != BOOT_DFU_NONE || !IS_ENABLED(CONFIG_RAD_BOOT_FAST_BOOT)) {
+        if (hsusb_init() == 0) {
+            timeline_mark(BOOT_TL_USB_INIT);
+            do {
+                installed |= dfu_session(slot >= 0);
+#ifdef CONFIG_RAD_BOOT_SWAP
+                installed |= (swap_install() == 0);
+#endif
+                slot = boot_slot_select();
+#ifdef CONFIG_RAD_BOOT_DFU
+                dfu_slot_update(slot);
+#endif
+            } while (slot < 0);
+            timeline_mark(BOOT_TL_DFU_DONE);
+        }
+    }
 #endif
     //end of customer code
 
-    jump_to_image(TARGET_IMAGE_ADDRESS);
+    if (slot < 0) {
+        LOG_PRINTK("No valid image, halting\n");
+        k_sleep(K_FOREVER);
+    }
+
+    handoff_prepare(slot, reason, installed);
+    jump_to_image(image_entry(slot));
 
     return 0;
 }
@@ -216,6 +504,202 @@ int main(void)
 
 /* Private Functions ---------------------------------------------------------*/
 
+/**
+ * @brief Sanity check the vector table of an image
+ *
+ * Erased MRAM, a stack pointer outside RAM or a reset handler outside the
+ * partition all mean there is nothing bootable at @p image_addr.
+ *
+ * @param image_addr Address of the vector table
+ * @param slot_end End of the partition holding the image
+ *
+ * @return true if the image looks bootable
+ */
+static bool vector_table_check(uint32_t image_addr, uint32_t slot_end)
+{
+	const arm_vector_table_t *vt = (const arm_vector_table_t *)image_addr;
+
+	if (vt->msp == 0xFFFFFFFF || vt->reset_vector == 0xFFFFFFFF) {
+		return false;
+	}
+
+	if (vt->msp <= SRAM_START || vt->msp > SRAM_END || (vt->msp & 0x7) != 0) {
+		return false;
+	}
+
+	/* Reset handler must be a Thumb address inside the partition */
+	if ((vt->reset_vector & 0x1) == 0 ||
+	    vt->reset_vector < image_addr ||
+	    vt->reset_vector >= slot_end) {
+		return false;
+	}
+
+	return true;
+}
+
+static bool vector_table_is_valid(enum image_slot slot)
+{
+	return vector_table_check(image_entry(slot),
+				  image_slot_addr(slot) + image_slot_size(slot));
+}
+
+#ifdef CONFIG_RAD_BOOT_STAGE0
+/**
+ * @brief Chain-load the USB DFU stage-1
+ *
+ * Stage-1 runs the same boot flow with USB and DFU built in. It carries
+ * an image header like the application and is only started if its digest
+ * and, with CONFIG_RAD_BOOT_SIGNATURE, its signature check out. The DFU
+ * request flag is set again so it stays in DFU mode instead of starting
+ * the application right back. Returns only if no valid stage-1 is
+ * programmed.
+ */
+static void stage1_start(void)
+{
+	int err = image_validate_stage1();
+
+	if (err != 0 ||
+	    !vector_table_check(image_stage1_entry(), STAGE1_ADDR + STAGE1_SIZE)) {
+		LOG_PRINTK("No valid DFU stage-1 at 0x%08x (%d)\n", STAGE1_ADDR, err);
+		return;
+	}
+
+	boot_retained->dfu_request = BOOT_DFU_REQUEST_MAGIC;
+	jump_to_image(image_stage1_entry());
+}
+#endif
+
+#ifdef CONFIG_RAD_BOOT_ROLLBACK
+/**
+ * @brief Raise the rollback counter to the image the application confirmed
+ *
+ * The application calls boot_confirm_image() once the image it was started
+ * with works. The version is taken from the handoff record of that boot,
+ * not from the application, and the confirmation is consumed here. An
+ * image that never confirms leaves the counter alone, so the previous
+ * image stays bootable.
+ */
+static void rollback_confirm_take(void)
+{
+	const struct boot_handoff *prev = handoff_previous();
+
+	if (boot_retained->confirm != BOOT_CONFIRM_MAGIC) {
+		return;
+	}
+
+	boot_retained->confirm = 0;
+
+	if (prev == NULL) {
+		LOG_PRINTK("Image confirmed without a boot record, ignored\n");
+		return;
+	}
+
+	if (rollback_counter_set(rollback_image_value(
+			(const struct image_version *)&prev->image)) != 0) {
+		LOG_PRINTK("Rollback counter update failed\n");
+	}
+}
+#endif
+
+/**
+ * @brief Pick the image to start
+ *
+ * An image qualifies if it matches its header digest, is linked for its
+ * slot, has a sane vector table and, with CONFIG_RAD_BOOT_ROLLBACK, is not
+ * below the rollback counter. With CONFIG_RAD_BOOT_XIP_AB the
+ * qualifying image with the newest version wins, cpurad_app_partition on
+ * a tie; otherwise only cpurad_app_partition is considered.
+ *
+ * @return Slot to start, -ENOENT if no slot holds a bootable image
+ */
+static int boot_slot_select(void)
+{
+	int count = IS_ENABLED(CONFIG_RAD_BOOT_XIP_AB) ? IMAGE_SLOT_COUNT : 1;
+	const struct image_header *best_hdr = NULL;
+	int best = -ENOENT;
+
+	for (int slot = 0; slot < count; slot++) {
+		const struct image_header *hdr;
+
+		if (image_validate(slot) != 0 || !vector_table_is_valid(slot)) {
+			continue;
+		}
+
+		hdr = image_header_get(slot);
+		if (IS_ENABLED(CONFIG_RAD_BOOT_ROLLBACK) && !rollback_allows(&hdr->version)) {
+			LOG_PRINTK("Slot %d is below the rollback counter\n", slot);
+			continue;
+		}
+
+		if (best_hdr == NULL ||
+		    image_version_cmp(&hdr->version, &best_hdr->version) > 0) {
+			best = slot;
+			best_hdr = hdr;
+		}
+	}
+
+	if (best_hdr != NULL) {
+		LOG_PRINTK("Boot slot %d, version %u.%u.%u+%u\n", best,
+			   best_hdr->version.major, best_hdr->version.minor,
+			   best_hdr->version.revision, best_hdr->version.build);
+	}
+
+	return best;
+}
+
+#ifdef CONFIG_RAD_BOOT_DFU
+/**
+ * @brief Point the DFU engine away from the image that is going to run
+ *
+ * With CONFIG_RAD_BOOT_XIP_AB the engine writes whichever slot is not
+ * @p boot_slot. Otherwise it keeps writing cpurad_app2_partition.
+ *
+ * @param boot_slot Result of boot_slot_select()
+ */
+static void dfu_slot_update(int boot_slot)
+{
+	if (IS_ENABLED(CONFIG_RAD_BOOT_XIP_AB)) {
+		dfu_engine_set_slot(boot_slot == IMAGE_SLOT_SECONDARY ?
+				    IMAGE_SLOT_PRIMARY : IMAGE_SLOT_SECONDARY);
+	}
+}
+#endif
+
+/**
+ * @brief Decide at reset whether the bootloader has to stay in DFU mode
+ *
+ * The retained RAM request flag is consumed here, so a request only
+ * applies to the reset that follows it.
+ *
+ * @param app_valid true if boot_slot_select() found an image
+ *
+ * @return Reason to enter DFU mode, BOOT_DFU_NONE to boot right away
+ */
+static enum boot_dfu_reason dfu_reason_get(bool app_valid)
+{
+	bool requested = (boot_retained->dfu_request == BOOT_DFU_REQUEST_MAGIC);
+
+	boot_retained->dfu_request = 0;
+
+	if (!app_valid) {
+		return BOOT_DFU_NO_IMAGE;
+	}
+
+	if (requested) {
+		return BOOT_DFU_REQUESTED;
+	}
+
+	if (IS_ENABLED(CONFIG_RAD_BOOT_DFU_STRAP)) {
+		/* P0.08 is the DK button 0, active low */
+		nrf_gpio_cfg_input(TEST_PIN_2, NRF_GPIO_PIN_PULLUP);
+		if (nrf_gpio_pin_read(TEST_PIN_2) == 0) {
+			return BOOT_DFU_STRAP;
+		}
+	}
+
+	return BOOT_DFU_NONE;
+}
+
 /**
  * @brief Jump to another image at specified address
  *
@@ -238,20 +722,26 @@ static void __attribute__((noreturn)) jump_to_image(uint32_t image_addr)
 
 #ifdef CONFIG_USB_DEVICE_STACK_NEXT
 	/* Properly shutdown USB before jumping */
-	if (sample_usbd != NULL) {
+	if (usb_started) {
 		LOG_PRINTK("Shutting down USB\n");
 		usbd_disable(sample_usbd);
+		/* Bounded wait for the class to report the interface down */
+		(void)k_event_wait(&usb_events, USB_EVT_IFACE_DOWN, false,
+				   K_MSEC(CONFIG_RAD_BOOT_USB_SHUTDOWN_TIMEOUT_MS));
 		usbd_shutdown(sample_usbd);
-		k_msleep(1000); /* Wait for USB to fully shutdown */
+		(void)nrf_cleanup_usb();
+		timeline_mark(BOOT_TL_USB_SHUTDOWN);
 	}
 #endif
-    
+
+    /* Stages from here on are only visible to the application */
+    timeline_log();
+
     nrf_cleanup_peripheral();
+    timeline_mark(BOOT_TL_PERIPH_CLEANUP);
     cleanup_arm_nvic(); /* cleanup NVIC registers */
-    
-    /* Additional delay for VBUS detection service to stabilize */
-    k_msleep(500);
-    
+    timeline_mark(BOOT_TL_NVIC_CLEANUP);
+
     LOG_PRINTK("GPIO and peripheral cleanup completed\n");
 
     /* Flush and disable instruction/data caches before chain-loading the application */
@@ -259,21 +749,31 @@ static void __attribute__((noreturn)) jump_to_image(uint32_t image_addr)
     (void)sys_cache_data_flush_all();
     sys_cache_instr_disable();
     sys_cache_data_disable();
+    timeline_mark(BOOT_TL_CACHE_FLUSH);
 
 	z_arm_clear_arm_mpu_config();
 
+	/* Last calls on the bootloader stack, only the branch follows the
+	 * switch to the application's
+	 */
+	timeline_mark(BOOT_TL_JUMP);
+	handoff_seal();
+
+	const uint32_t msp = vt->msp;
+	void (*const reset_vector)(void) = (void (*)(void))vt->reset_vector;
+
 #if defined(CONFIG_BUILTIN_STACK_GUARD) && defined(CONFIG_CPU_CORTEX_M_HAS_SPLIM)
 	/* Reset stack limit registers */
 	__set_PSPLIM(0);
 	__set_MSPLIM(0);
 #endif
 
-	__set_MSP(vt->msp);
+	__set_MSP(msp);
     __set_CONTROL(0x00); /* application will configures core on its own */
 	__ISB();
 
 	/* Jump to the new image reset vector */
-	((void (*)(void))vt->reset_vector)();
+	reset_vector();
 
 	/* Should never reach here */
 	CODE_UNREACHABLE;
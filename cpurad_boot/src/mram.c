@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/storage/flash_map.h>
+#include <mram.h>
+
+/* Largest write block size handled, MRAM uses 16 bytes */
+#define MRAM_UNIT_MAX           32
+#define MRAM_CMP_BUF_SIZE       256
+
+BUILD_ASSERT(MRAM_CMP_BUF_SIZE % MRAM_UNIT_MAX == 0,
+	     "compare buffer must hold whole write units");
+
+static struct mram_stats mram_stats;
+
+static int mram_program(const struct flash_area *fa, off_t off, const uint8_t *data,
+			size_t len, size_t unit)
+{
+	int err = flash_area_write(fa, off, data, len);
+
+	if (err == 0) {
+		mram_stats.blocks_written += len / unit;
+	}
+
+	return err;
+}
+
+/* @p off and @p len are multiples of @p unit */
+static int mram_write_units(const struct flash_area *fa, off_t off, const uint8_t *data,
+			    size_t len, size_t unit)
+{
+	uint8_t cur[MRAM_CMP_BUF_SIZE] __aligned(4);
+	size_t run = SIZE_MAX;
+	int err = 0;
+
+	if (!IS_ENABLED(CONFIG_RAD_BOOT_MRAM_COMPARE)) {
+		return mram_program(fa, off, data, len, unit);
+	}
+
+	for (size_t pos = 0; pos < len && err == 0; pos += sizeof(cur)) {
+		size_t n = MIN(sizeof(cur), len - pos);
+
+		err = flash_area_read(fa, off + pos, cur, n);
+
+		for (size_t u = 0; u < n && err == 0; u += unit) {
+			if (memcmp(&cur[u], &data[pos + u], unit) != 0) {
+				if (run == SIZE_MAX) {
+					run = pos + u;
+				}
+				continue;
+			}
+
+			mram_stats.blocks_skipped++;
+
+			/* An unchanged unit ends the run of differing ones */
+			if (run != SIZE_MAX) {
+				err = mram_program(fa, off + run, &data[run], pos + u - run, unit);
+				run = SIZE_MAX;
+			}
+		}
+	}
+
+	if (err == 0 && run != SIZE_MAX) {
+		err = mram_program(fa, off + run, &data[run], len - run, unit);
+	}
+
+	return err;
+}
+
+int mram_write(const struct flash_area *fa, off_t off, const void *data, size_t len)
+{
+	const uint8_t *src = data;
+	size_t unit = flash_area_align(fa);
+	uint8_t blk[MRAM_UNIT_MAX] __aligned(4);
+	int err = 0;
+
+	if (unit == 0 || unit > MRAM_UNIT_MAX || (MRAM_UNIT_MAX % unit) != 0) {
+		return -EINVAL;
+	}
+
+	while (len > 0 && err == 0) {
+		off_t base = ROUND_DOWN(off, unit);
+		size_t head = off - base;
+		size_t n;
+
+		if (head == 0 && len >= unit) {
+			n = ROUND_DOWN(len, unit);
+			err = mram_write_units(fa, off, src, n, unit);
+		} else {
+			/* Partial unit: merge with what is there */
+			n = MIN(len, unit - head);
+			err = flash_area_read(fa, base, blk, unit);
+			if (err == 0) {
+				memcpy(&blk[head], src, n);
+				err = mram_write_units(fa, base, blk, unit, unit);
+			}
+		}
+
+		off += n;
+		src += n;
+		len -= n;
+	}
+
+	return err;
+}
+
+void mram_stats_get(struct mram_stats *stats)
+{
+	*stats = mram_stats;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * The parts of the peripheral cleanup that need no nRF HAL: running the
+ * table and the USB core reset sequence. Registers are only reached
+ * through the base addresses passed in, so tests/nrf_cleanup runs this
+ * file against a register file in RAM.
+ */
+
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+#include <nrf_cleanup.h>
+#include <timeline.h>
+
+/* DWC2 core registers used to hand the USBHS controller over */
+#define DWC2_GRSTCTL                  0x010
+#define DWC2_GRSTCTL_CSFTRST          BIT(0)
+#define DWC2_GRSTCTL_AHBIDLE          BIT(31)
+#define DWC2_GINTMSK                  0x014
+#define DWC2_DCTL                     0x804
+#define DWC2_DCTL_SFTDISCON           BIT(1)
+#define DWC2_DIEPMSK                  0x810
+#define DWC2_DOEPMSK                  0x814
+#define DWC2_DAINTMSK                 0x81C
+
+#define NRF_CLEANUP_REG(base, offs)   (*(volatile uint32_t *)((base) + (offs)))
+
+void nrf_cleanup_table_run(const struct nrf_cleanup_entry *table, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (table[i].reset != NULL) {
+            table[i].reset(&table[i]);
+        }
+    }
+}
+
+int nrf_cleanup_usb_core(uintptr_t usb_base)
+{
+    uint32_t waited_us;
+    int err;
+
+    /* Disconnect USB device first */
+    NRF_CLEANUP_REG(usb_base, DWC2_DCTL) |= DWC2_DCTL_SFTDISCON;
+
+    /* Give the disconnect time to take effect */
+    timeline_delay_us(CONFIG_RAD_BOOT_USB_DISCONNECT_US);
+    timeline_mark(BOOT_TL_USB_DISCONNECT);
+
+    /* Disable USB interrupts */
+    NRF_CLEANUP_REG(usb_base, DWC2_GINTMSK) = 0;
+    NRF_CLEANUP_REG(usb_base, DWC2_DIEPMSK) = 0;
+    NRF_CLEANUP_REG(usb_base, DWC2_DOEPMSK) = 0;
+    NRF_CLEANUP_REG(usb_base, DWC2_DAINTMSK) = 0;
+
+    /* Soft reset USB core once no AHB transfer is in progress */
+    err = timeline_poll(&NRF_CLEANUP_REG(usb_base, DWC2_GRSTCTL), DWC2_GRSTCTL_AHBIDLE,
+                        DWC2_GRSTCTL_AHBIDLE, CONFIG_RAD_BOOT_USB_RESET_TIMEOUT_US, &waited_us);
+    if (err != 0) {
+        printk("[cleanup] USB AHB idle wait timed out after %u us\n", waited_us);
+    }
+
+    NRF_CLEANUP_REG(usb_base, DWC2_GRSTCTL) |= DWC2_GRSTCTL_CSFTRST;
+
+    err = timeline_poll(&NRF_CLEANUP_REG(usb_base, DWC2_GRSTCTL), DWC2_GRSTCTL_CSFTRST, 0,
+                        CONFIG_RAD_BOOT_USB_RESET_TIMEOUT_US, &waited_us);
+    timeline_mark(BOOT_TL_USB_CORE_RESET);
+    if (err != 0) {
+        printk("[cleanup] USB core reset timed out after %u us\n", waited_us);
+    }
+
+    return err;
+}
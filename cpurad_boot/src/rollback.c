@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/printk.h>
+#include <mram.h>
+#include <rollback.h>
+#include <timeline.h>
+
+#define ROLLBACK_PARTITION      DT_NODELABEL(boot_counter_partition)
+#define ROLLBACK_REC_COUNT      (DT_REG_SIZE(ROLLBACK_PARTITION) / sizeof(struct rollback_rec))
+/* Records read at once while scanning */
+#define ROLLBACK_SCAN_BATCH     16
+
+BUILD_ASSERT(sizeof(struct rollback_rec) == 16,
+	     "rollback_rec must be one MRAM write block");
+BUILD_ASSERT(DT_REG_SIZE(ROLLBACK_PARTITION) / 16 >= 2,
+	     "boot_counter_partition must hold at least two records");
+
+static const struct flash_area *rollback_fa;
+static bool rollback_loaded;
+static uint32_t rollback_value;
+static uint32_t rollback_seq;
+/* Index of the newest record, the next one is written after it */
+static uint32_t rollback_head;
+
+static uint32_t rollback_crc(const struct rollback_rec *rec)
+{
+	return crc32_ieee((const uint8_t *)rec, offsetof(struct rollback_rec, crc));
+}
+
+static int rollback_load(void)
+{
+	struct rollback_rec rec[ROLLBACK_SCAN_BATCH];
+	uint32_t start = timeline_now();
+	uint32_t valid = 0;
+	int err;
+
+	if (rollback_loaded) {
+		return 0;
+	}
+
+	if (rollback_fa == NULL) {
+		err = flash_area_open(FIXED_PARTITION_ID(boot_counter_partition), &rollback_fa);
+		if (err != 0) {
+			rollback_fa = NULL;
+			return err;
+		}
+	}
+
+	/* Nothing written yet: the first record goes to index 0 */
+	rollback_value = 0;
+	rollback_seq = 0;
+	rollback_head = ROLLBACK_REC_COUNT - 1;
+
+	for (uint32_t i = 0; i < ROLLBACK_REC_COUNT; i += ROLLBACK_SCAN_BATCH) {
+		uint32_t n = MIN(ROLLBACK_SCAN_BATCH, ROLLBACK_REC_COUNT - i);
+
+		err = flash_area_read(rollback_fa, i * sizeof(rec[0]), rec, n * sizeof(rec[0]));
+		if (err != 0) {
+			return err;
+		}
+
+		for (uint32_t j = 0; j < n; j++) {
+			if (rec[j].magic != ROLLBACK_MAGIC || rec[j].crc != rollback_crc(&rec[j])) {
+				continue;
+			}
+
+			valid++;
+			if (rec[j].seq > rollback_seq) {
+				rollback_seq = rec[j].seq;
+				rollback_value = rec[j].value;
+				rollback_head = i + j;
+			}
+		}
+	}
+
+	rollback_loaded = true;
+
+	printk("[rollback] counter %u, %u records, lookup %u us\n", rollback_value, valid,
+	       timeline_cyc_to_us(timeline_now() - start));
+
+	return 0;
+}
+
+uint32_t rollback_image_value(const struct image_version *version)
+{
+	return ((uint32_t)version->major << 24) | ((uint32_t)version->minor << 16) |
+	       version->revision;
+}
+
+int rollback_counter_get(uint32_t *value)
+{
+	int err = rollback_load();
+
+	if (err == 0) {
+		*value = rollback_value;
+	}
+
+	return err;
+}
+
+int rollback_counter_set(uint32_t value)
+{
+	struct rollback_rec rec;
+	uint32_t next;
+	int err;
+
+	err = rollback_load();
+	if (err != 0 || value <= rollback_value) {
+		return err;
+	}
+
+	rec.magic = ROLLBACK_MAGIC;
+	rec.seq = rollback_seq + 1;
+	rec.value = value;
+	rec.crc = rollback_crc(&rec);
+
+	/* Overwrites the oldest record, never the current one */
+	next = (rollback_head + 1) % ROLLBACK_REC_COUNT;
+	err = mram_write(rollback_fa, next * sizeof(rec), &rec, sizeof(rec));
+	if (err != 0) {
+		return err;
+	}
+
+	rollback_value = value;
+	rollback_seq = rec.seq;
+	rollback_head = next;
+
+	printk("[rollback] counter raised to %u\n", value);
+
+	return 0;
+}
+
+bool rollback_allows(const struct image_version *version)
+{
+	uint32_t value;
+
+	return rollback_counter_get(&value) == 0 && rollback_image_value(version) >= value;
+}
+
+#ifdef CONFIG_ZTEST
+void rollback_test_reset(void)
+{
+	rollback_loaded = false;
+}
+
+uint32_t rollback_test_head(void)
+{
+	return rollback_head;
+}
+#endif
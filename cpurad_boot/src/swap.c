@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/printk.h>
+#include <image.h>
+#include <mram.h>
+#include <swap.h>
+#include <timeline.h>
+
+#define SWAP_CHUNK_SIZE         DT_REG_SIZE(DT_NODELABEL(boot_scratch_partition))
+#define SWAP_WRITE_BLOCK        16
+#define SWAP_COPY_BUF_SIZE      1024
+
+#define SWAP_JOURNAL_MAGIC      0x50415753 /* "SWAP" */
+
+enum swap_step {
+	SWAP_STEP_SAVE = 0,         /* primary -> scratch */
+	SWAP_STEP_INSTALL,          /* secondary -> primary */
+	SWAP_STEP_RESTORE,          /* scratch -> secondary */
+};
+
+/* The journal holds two records written alternately. The valid record with
+ * the higher sequence number is the current one, so a write torn by a reset
+ * loses at most the last step, which is then repeated.
+ */
+struct swap_journal_rec {
+	uint32_t magic;
+	uint32_t seq;
+	/* Bytes to swap from the start of each slot */
+	uint32_t size;
+	/* Next chunk and step to run, chunk * SWAP_CHUNK_SIZE >= size when done */
+	uint32_t chunk;
+	uint32_t step;
+	uint32_t reserved[2];
+	uint32_t crc;
+};
+
+BUILD_ASSERT(sizeof(struct swap_journal_rec) % SWAP_WRITE_BLOCK == 0,
+	     "swap_journal_rec must be a multiple of the MRAM write block");
+BUILD_ASSERT(SWAP_CHUNK_SIZE % SWAP_COPY_BUF_SIZE == 0,
+	     "boot_scratch_partition must be a multiple of the copy buffer");
+
+static const struct flash_area *swap_fa[IMAGE_SLOT_COUNT];
+static const struct flash_area *scratch_fa;
+static const struct flash_area *journal_fa;
+
+static uint32_t swap_journal_crc(const struct swap_journal_rec *rec)
+{
+	return crc32_ieee((const uint8_t *)rec, offsetof(struct swap_journal_rec, crc));
+}
+
+static bool swap_journal_read(struct swap_journal_rec *out)
+{
+	struct swap_journal_rec rec[2];
+	bool found = false;
+
+	if (flash_area_read(journal_fa, 0, rec, sizeof(rec)) != 0) {
+		return false;
+	}
+
+	for (int i = 0; i < ARRAY_SIZE(rec); i++) {
+		if (rec[i].magic != SWAP_JOURNAL_MAGIC ||
+		    rec[i].crc != swap_journal_crc(&rec[i])) {
+			continue;
+		}
+
+		if (!found || rec[i].seq > out->seq) {
+			*out = rec[i];
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+static int swap_journal_write(struct swap_journal_rec *rec)
+{
+	rec->magic = SWAP_JOURNAL_MAGIC;
+	rec->seq++;
+	rec->crc = swap_journal_crc(rec);
+
+	return mram_write(journal_fa, (rec->seq & 1) * sizeof(*rec), rec, sizeof(*rec));
+}
+
+static bool swap_journal_busy(const struct swap_journal_rec *rec)
+{
+	return (uint64_t)rec->chunk * SWAP_CHUNK_SIZE < rec->size;
+}
+
+static int swap_copy(const struct flash_area *dst, off_t dst_off,
+		     const struct flash_area *src, off_t src_off, size_t len)
+{
+	static uint8_t buf[SWAP_COPY_BUF_SIZE] __aligned(4);
+	int err = 0;
+
+	for (size_t off = 0; off < len && err == 0; off += sizeof(buf)) {
+		size_t n = MIN(sizeof(buf), len - off);
+
+		err = flash_area_read(src, src_off + off, buf, n);
+		if (err == 0) {
+			err = mram_write(dst, dst_off + off, buf, n);
+		}
+	}
+
+	return err;
+}
+
+static int swap_step_run(const struct swap_journal_rec *rec)
+{
+	off_t off = (off_t)rec->chunk * SWAP_CHUNK_SIZE;
+	size_t len = MIN(SWAP_CHUNK_SIZE, rec->size - off);
+
+	switch (rec->step) {
+	case SWAP_STEP_SAVE:
+		return swap_copy(scratch_fa, 0, swap_fa[IMAGE_SLOT_PRIMARY], off, len);
+	case SWAP_STEP_INSTALL:
+		return swap_copy(swap_fa[IMAGE_SLOT_PRIMARY], off,
+				 swap_fa[IMAGE_SLOT_SECONDARY], off, len);
+	case SWAP_STEP_RESTORE:
+		return swap_copy(swap_fa[IMAGE_SLOT_SECONDARY], off, scratch_fa, 0, len);
+	default:
+		return -EINVAL;
+	}
+}
+
+static int swap_open(void)
+{
+	int err = 0;
+
+	for (int slot = 0; slot < IMAGE_SLOT_COUNT && err == 0; slot++) {
+		if (swap_fa[slot] == NULL) {
+			err = flash_area_open(image_slot_fa_id(slot), &swap_fa[slot]);
+		}
+	}
+
+	if (err == 0 && scratch_fa == NULL) {
+		err = flash_area_open(FIXED_PARTITION_ID(boot_scratch_partition), &scratch_fa);
+	}
+
+	if (err == 0 && journal_fa == NULL) {
+		err = flash_area_open(FIXED_PARTITION_ID(boot_journal_partition), &journal_fa);
+	}
+
+	return err;
+}
+
+/* Bytes to swap for a new image in the secondary slot, 0 if there is none */
+static uint32_t swap_size_get(void)
+{
+	const struct image_header *pri = image_header_get(IMAGE_SLOT_PRIMARY);
+	const struct image_header *sec = image_header_get(IMAGE_SLOT_SECONDARY);
+	uint32_t size;
+
+	if (sec == NULL || image_validate(IMAGE_SLOT_SECONDARY) != 0) {
+		return 0;
+	}
+
+	if (pri != NULL && image_validate(IMAGE_SLOT_PRIMARY) == 0 &&
+	    image_version_cmp(&sec->version, &pri->version) <= 0) {
+		return 0;
+	}
+
+	/* Only the old image's own bytes need to survive in the secondary slot */
+	size = sec->hdr_size + sec->img_size;
+	if (pri != NULL) {
+		size = MAX(size, pri->hdr_size + pri->img_size);
+	}
+
+	return MIN(ROUND_UP(size, SWAP_WRITE_BLOCK),
+		   MIN(swap_fa[IMAGE_SLOT_PRIMARY]->fa_size,
+		       swap_fa[IMAGE_SLOT_SECONDARY]->fa_size));
+}
+
+int swap_install(void)
+{
+	/* Keeps the sequence number of a finished swap if there was one */
+	struct swap_journal_rec rec = { 0 };
+	struct mram_stats before;
+	struct mram_stats after;
+	uint32_t start = timeline_now();
+	uint32_t done = 0;
+	uint32_t us;
+	int err;
+
+	err = swap_open();
+	if (err != 0) {
+		return err;
+	}
+
+	if (swap_journal_read(&rec) && swap_journal_busy(&rec)) {
+		printk("[swap] resuming at chunk %u step %u, journal read %u us\n",
+		       rec.chunk, rec.step, timeline_cyc_to_us(timeline_now() - start));
+		done = rec.chunk * SWAP_CHUNK_SIZE;
+	} else {
+		rec.size = swap_size_get();
+		if (rec.size == 0) {
+			return -EALREADY;
+		}
+
+		rec.chunk = 0;
+		rec.step = SWAP_STEP_SAVE;
+		err = swap_journal_write(&rec);
+		if (err != 0) {
+			return err;
+		}
+
+		printk("[swap] installing %u bytes from cpurad_app2_partition\n", rec.size);
+	}
+
+	/* Neither slot matches its cached result until the swap is over */
+	image_cache_invalidate(IMAGE_SLOT_PRIMARY);
+	image_cache_invalidate(IMAGE_SLOT_SECONDARY);
+
+	mram_stats_get(&before);
+	start = timeline_now();
+	while (swap_journal_busy(&rec)) {
+		err = swap_step_run(&rec);
+		if (err != 0) {
+			printk("[swap] chunk %u step %u failed, %d\n", rec.chunk, rec.step, err);
+			return err;
+		}
+
+		if (rec.step == SWAP_STEP_RESTORE) {
+			rec.step = SWAP_STEP_SAVE;
+			rec.chunk++;
+		} else {
+			rec.step++;
+		}
+
+		err = swap_journal_write(&rec);
+		if (err != 0) {
+			return err;
+		}
+	}
+
+	us = timeline_cyc_to_us(timeline_now() - start);
+	done = rec.size - done;
+	mram_stats_get(&after);
+
+	printk("[swap] %u bytes in %u us (%u KB/s), %u blocks written, %u skipped\n",
+	       done, us, us ? (uint32_t)((uint64_t)done * 1000000 / 1024 / us) : 0,
+	       after.blocks_written - before.blocks_written,
+	       after.blocks_skipped - before.blocks_skipped);
+
+	return 0;
+}
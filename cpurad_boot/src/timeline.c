@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/printk.h>
+#include <cortex_m/dwt.h>
+#include <boot_retained.h>
+#include <timeline.h>
+
+static const char *const stage_name[BOOT_TL_STAGE_COUNT] = {
+	[BOOT_TL_EARLY_INIT] = "early init",
+	[BOOT_TL_MAIN] = "main",
+	[BOOT_TL_DECISION] = "boot decision",
+	[BOOT_TL_USB_INIT] = "USB init",
+	[BOOT_TL_DFU_DONE] = "DFU session",
+	[BOOT_TL_USB_SHUTDOWN] = "USB shutdown",
+	[BOOT_TL_PERIPH_CLEANUP] = "periph cleanup",
+	[BOOT_TL_NVIC_CLEANUP] = "NVIC cleanup",
+	[BOOT_TL_CACHE_FLUSH] = "cache flush",
+	[BOOT_TL_JUMP] = "jump",
+	[BOOT_TL_APP_MAIN] = "app main",
+	[BOOT_TL_USB_DISCONNECT] = "USB disconnect",
+	[BOOT_TL_USB_CORE_RESET] = "USB core reset",
+	[BOOT_TL_STAGE1] = "stage-1 start",
+};
+
+uint32_t timeline_now(void)
+{
+	return z_arm_dwt_get_cycles();
+}
+
+uint32_t timeline_cyc_to_us(uint32_t cycles)
+{
+	return (uint32_t)(((uint64_t)cycles * USEC_PER_SEC) / SystemCoreClock);
+}
+
+uint32_t timeline_us_to_cyc(uint32_t us)
+{
+	return (uint32_t)(((uint64_t)us * SystemCoreClock) / USEC_PER_SEC);
+}
+
+int timeline_poll(const volatile uint32_t *reg, uint32_t mask, uint32_t expect,
+		  uint32_t timeout_us, uint32_t *waited_us)
+{
+	uint32_t limit = timeline_us_to_cyc(timeout_us);
+	uint32_t start = timeline_now();
+	uint32_t elapsed;
+	int err = -ETIMEDOUT;
+
+	do {
+		/* Sampled before the register, a match at the deadline counts */
+		elapsed = timeline_now() - start;
+		if ((*reg & mask) == expect) {
+			err = 0;
+			break;
+		}
+	} while (elapsed < limit);
+
+	*waited_us = timeline_cyc_to_us(elapsed);
+
+	return err;
+}
+
+void timeline_delay_us(uint32_t us)
+{
+	uint32_t limit = timeline_us_to_cyc(us);
+	uint32_t start = timeline_now();
+
+	while (timeline_now() - start < limit) {
+	}
+}
+
+void timeline_mark(enum boot_tl_stage stage)
+{
+	volatile struct boot_timeline *tl = &boot_retained->timeline;
+	unsigned int key = irq_lock();
+
+	boot_timeline_append(tl, stage, z_arm_dwt_get_cycles());
+
+	irq_unlock(key);
+}
+
+void timeline_log(void)
+{
+	volatile struct boot_timeline *tl = &boot_retained->timeline;
+	uint32_t prev = 0;
+
+	for (int i = 0; i < tl->count; i++) {
+		printk("[boot] %-16s %8u us (+%u us)\n", stage_name[tl->stage[i]],
+		       tl->stamp[i], tl->stamp[i] - prev);
+		prev = tl->stamp[i];
+	}
+}
+
+/* Count the counter wraps while the bootloader waits, for instance for a
+ * DFU session. timeline_mark() counts them too, so this only has to run
+ * once per wrap period.
+ */
+static void timeline_sync_handler(struct k_timer *timer)
+{
+	unsigned int key = irq_lock();
+
+	ARG_UNUSED(timer);
+
+	(void)boot_timeline_sync(&boot_retained->timeline, z_arm_dwt_get_cycles());
+
+	irq_unlock(key);
+}
+
+static K_TIMER_DEFINE(timeline_sync_timer, timeline_sync_handler, NULL);
+
+static int timeline_sync_start(void)
+{
+	k_timeout_t period = K_MSEC(MSEC_PER_SEC * (UINT32_MAX / SystemCoreClock) / 2);
+
+	k_timer_start(&timeline_sync_timer, period, period);
+
+	return 0;
+}
+
+/* Start the cycle counter as early as possible so that the stamps cover
+ * kernel and driver initialization as well.
+ */
+static int timeline_init(void)
+{
+	volatile struct boot_timeline *tl = &boot_retained->timeline;
+
+	z_arm_dwt_init();
+
+	/* Chain-loaded by stage-0: its counter and stamps keep going */
+	if (IS_ENABLED(CONFIG_RAD_BOOT_STAGE1) && boot_timeline_is_valid(tl)) {
+		timeline_mark(BOOT_TL_STAGE1);
+		return 0;
+	}
+
+	z_arm_dwt_cycle_count_start();
+
+	boot_timeline_reset(tl, SystemCoreClock);
+
+	timeline_mark(BOOT_TL_EARLY_INIT);
+
+	return 0;
+}
+
+SYS_INIT(timeline_init, PRE_KERNEL_1, 0);
+SYS_INIT(timeline_sync_start, POST_KERNEL, 0);
@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <unlz4.h>
+
+#define UNLZ4_WINDOW_SIZE       CONFIG_RAD_BOOT_LZ4_WINDOW_SIZE
+#define UNLZ4_MIN_MATCH         4
+
+BUILD_ASSERT(UNLZ4_WINDOW_SIZE % 16 == 0,
+	     "CONFIG_RAD_BOOT_LZ4_WINDOW_SIZE must be a multiple of the MRAM write block");
+
+enum unlz4_state {
+	UNLZ4_STATE_HDR,
+	UNLZ4_STATE_TOKEN,
+	UNLZ4_STATE_LIT_LEN,        /* literal length continuation bytes */
+	UNLZ4_STATE_LITERALS,
+	UNLZ4_STATE_OFF_LO,
+	UNLZ4_STATE_OFF_HI,
+	UNLZ4_STATE_MATCH_LEN,      /* match length continuation bytes */
+	UNLZ4_STATE_END,            /* last literals written */
+};
+
+static const struct flash_area *unlz4_fa;
+static unlz4_emit_t unlz4_emit;
+static size_t unlz4_max_out;
+
+static enum unlz4_state unlz4_state;
+static uint8_t unlz4_stage[sizeof(struct unlz4_hdr)];
+static size_t unlz4_stage_len;
+static uint32_t unlz4_out_size;
+static uint8_t unlz4_token;
+static uint32_t unlz4_lit_len;
+static uint32_t unlz4_match_len;
+static uint16_t unlz4_offset;
+
+/* Output not yet emitted, starting at unlz4_out_off */
+static uint8_t unlz4_win[UNLZ4_WINDOW_SIZE] __aligned(4);
+static size_t unlz4_win_len;
+static uint32_t unlz4_out_off;
+
+static uint32_t unlz4_produced(void)
+{
+	return unlz4_out_off + unlz4_win_len;
+}
+
+static int unlz4_flush(void)
+{
+	int err;
+
+	if (unlz4_win_len == 0) {
+		return 0;
+	}
+
+	err = unlz4_emit(unlz4_out_off, unlz4_win, unlz4_win_len);
+	unlz4_out_off += unlz4_win_len;
+	unlz4_win_len = 0;
+
+	return err;
+}
+
+static int unlz4_literals(const uint8_t *data, size_t len)
+{
+	int err = 0;
+
+	while (len > 0 && err == 0) {
+		size_t n = MIN(len, sizeof(unlz4_win) - unlz4_win_len);
+
+		memcpy(&unlz4_win[unlz4_win_len], data, n);
+		unlz4_win_len += n;
+		data += n;
+		len -= n;
+
+		if (unlz4_win_len == sizeof(unlz4_win)) {
+			err = unlz4_flush();
+		}
+	}
+
+	return err;
+}
+
+static int unlz4_match(void)
+{
+	uint32_t len = unlz4_match_len;
+	uint32_t src;
+	int err = 0;
+
+	if (unlz4_offset == 0 || unlz4_offset > unlz4_produced()) {
+		return -EINVAL;
+	}
+
+	if ((uint64_t)unlz4_produced() + len > unlz4_out_size) {
+		return -EFBIG;
+	}
+
+	src = unlz4_produced() - unlz4_offset;
+
+	while (len > 0 && err == 0) {
+		size_t room = sizeof(unlz4_win) - unlz4_win_len;
+		size_t n;
+
+		if (src < unlz4_out_off) {
+			/* Already written out, read it back from the slot */
+			n = MIN(len, MIN(unlz4_out_off - src, room));
+			err = flash_area_read(unlz4_fa, src, &unlz4_win[unlz4_win_len], n);
+		} else {
+			/* Byte by byte: the match may overlap its own output */
+			const uint8_t *from = &unlz4_win[src - unlz4_out_off];
+
+			n = MIN(len, room);
+			for (size_t i = 0; i < n; i++) {
+				unlz4_win[unlz4_win_len + i] = from[i];
+			}
+		}
+
+		unlz4_win_len += n;
+		src += n;
+		len -= n;
+
+		if (err == 0 && unlz4_win_len == sizeof(unlz4_win)) {
+			err = unlz4_flush();
+		}
+	}
+
+	return err;
+}
+
+/* The last sequence of a block ends after its literals */
+static void unlz4_literals_done(void)
+{
+	unlz4_state = (unlz4_produced() == unlz4_out_size) ?
+		      UNLZ4_STATE_END : UNLZ4_STATE_OFF_LO;
+}
+
+static int unlz4_match_start(void)
+{
+	unlz4_state = UNLZ4_STATE_TOKEN;
+
+	return unlz4_match();
+}
+
+void unlz4_begin(const struct flash_area *out, size_t max_out, unlz4_emit_t emit)
+{
+	unlz4_fa = out;
+	unlz4_max_out = max_out;
+	unlz4_emit = emit;
+	unlz4_state = UNLZ4_STATE_HDR;
+	unlz4_stage_len = 0;
+	unlz4_win_len = 0;
+	unlz4_out_off = 0;
+}
+
+int unlz4_feed(const uint8_t *data, size_t len)
+{
+	int err = 0;
+
+	while (len > 0 && err == 0) {
+		uint8_t b = *data;
+		size_t n = 1;
+
+		switch (unlz4_state) {
+		case UNLZ4_STATE_HDR:
+			unlz4_stage[unlz4_stage_len++] = b;
+			if (unlz4_stage_len == sizeof(unlz4_stage)) {
+				struct unlz4_hdr hdr;
+
+				memcpy(&hdr, unlz4_stage, sizeof(hdr));
+				unlz4_out_size = sys_le32_to_cpu(hdr.out_size);
+				if (sys_le32_to_cpu(hdr.magic) != UNLZ4_MAGIC) {
+					err = -EINVAL;
+				} else if (unlz4_out_size == 0 || unlz4_out_size > unlz4_max_out) {
+					err = -EFBIG;
+				}
+				unlz4_state = UNLZ4_STATE_TOKEN;
+			}
+			break;
+		case UNLZ4_STATE_TOKEN:
+			unlz4_token = b;
+			unlz4_lit_len = b >> 4;
+			unlz4_match_len = (b & 0xF) + UNLZ4_MIN_MATCH;
+			if (unlz4_lit_len == 15) {
+				unlz4_state = UNLZ4_STATE_LIT_LEN;
+			} else if (unlz4_lit_len > 0) {
+				unlz4_state = UNLZ4_STATE_LITERALS;
+			} else {
+				unlz4_literals_done();
+			}
+			break;
+		case UNLZ4_STATE_LIT_LEN:
+			unlz4_lit_len += b;
+			if (b != 255) {
+				unlz4_state = UNLZ4_STATE_LITERALS;
+			}
+			break;
+		case UNLZ4_STATE_LITERALS:
+			n = MIN(len, unlz4_lit_len);
+			if ((uint64_t)unlz4_produced() + n > unlz4_out_size) {
+				err = -EFBIG;
+				break;
+			}
+			err = unlz4_literals(data, n);
+			unlz4_lit_len -= n;
+			if (unlz4_lit_len == 0) {
+				unlz4_literals_done();
+			}
+			break;
+		case UNLZ4_STATE_OFF_LO:
+			unlz4_offset = b;
+			unlz4_state = UNLZ4_STATE_OFF_HI;
+			break;
+		case UNLZ4_STATE_OFF_HI:
+			unlz4_offset |= b << 8;
+			if ((unlz4_token & 0xF) == 15) {
+				unlz4_state = UNLZ4_STATE_MATCH_LEN;
+			} else {
+				err = unlz4_match_start();
+			}
+			break;
+		case UNLZ4_STATE_MATCH_LEN:
+			unlz4_match_len += b;
+			if (b != 255) {
+				err = unlz4_match_start();
+			}
+			break;
+		case UNLZ4_STATE_END:
+		default:
+			err = -EINVAL;
+			break;
+		}
+
+		data += n;
+		len -= n;
+	}
+
+	return err;
+}
+
+int unlz4_finish(size_t *out_size)
+{
+	if (unlz4_state != UNLZ4_STATE_END) {
+		return -ENODATA;
+	}
+
+	*out_size = unlz4_produced();
+
+	return unlz4_flush();
+}
@@ -13,104 +13,257 @@
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/sys/util.h>
-#include <zephyr/irq.h>
-#include <hal/nrf_gpiote.h>
 
 #include <zephyr/usb/usbd.h>
 #include <zephyr/usb/class/usbd_hid.h>
 
 #include <zephyr/logging/log.h>
-LOG_MODULE_REGISTER(main, LOG_LEVEL_INF);
+#include <zephyr/sys/byteorder.h>
+#include <cortex_m/dwt.h>
+
+#include <boot_retained.h>
+#include <hid_stats.h>
 
-/* Define buttons for direct GPIO testing */
-static const struct gpio_dt_spec button0 = GPIO_DT_SPEC_GET(DT_ALIAS(sw0), gpios);
-static const struct gpio_dt_spec button1 = GPIO_DT_SPEC_GET(DT_ALIAS(sw1), gpios);
-static const struct gpio_dt_spec button2 = GPIO_DT_SPEC_GET(DT_ALIAS(sw2), gpios);
-static const struct gpio_dt_spec button3 = GPIO_DT_SPEC_GET(DT_ALIAS(sw3), gpios);
+#include "mouse_input.h"
+#include "mouse_latency.h"
+#include "mouse_ring.h"
+
+LOG_MODULE_REGISTER(main, LOG_LEVEL_INF);
 
 static const struct gpio_dt_spec led0 = GPIO_DT_SPEC_GET(DT_ALIAS(led0), gpios);
-static const uint8_t hid_report_desc[] = HID_MOUSE_REPORT_DESC(2);
 
-#define MOUSE_BTN_LEFT		0
-#define MOUSE_BTN_RIGHT		1
+#define MOUSE_REPORT_ID		1
+#define BOOT_TL_REPORT_ID	2
+
+/* version, count, stages, stamps */
+#define BOOT_TL_REPORT_SIZE	(2 + BOOT_TIMELINE_MAX + 4 * BOOT_TIMELINE_MAX)
+
+/* HID_MOUSE_REPORT_DESC(2) with a report ID, followed by a vendor defined
+ * collection carrying the boot timeline as a feature report and the input
+ * statistics collection, see hid_stats.h.
+ */
+static const uint8_t hid_report_desc[] = {
+	HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
+	HID_USAGE(HID_USAGE_GEN_DESKTOP_MOUSE),
+	HID_COLLECTION(HID_COLLECTION_APPLICATION),
+		HID_REPORT_ID(MOUSE_REPORT_ID),
+		HID_USAGE(HID_USAGE_GEN_DESKTOP_POINTER),
+		HID_COLLECTION(HID_COLLECTION_PHYSICAL),
+			HID_USAGE_PAGE(HID_USAGE_GEN_BUTTON),
+			HID_USAGE_MIN8(1),
+			HID_USAGE_MAX8(2),
+			HID_LOGICAL_MIN8(0),
+			HID_LOGICAL_MAX8(1),
+			HID_REPORT_SIZE(1),
+			HID_REPORT_COUNT(2),
+			HID_INPUT(0x02),
+			HID_REPORT_SIZE(6),
+			HID_REPORT_COUNT(1),
+			HID_INPUT(0x01),
+			HID_USAGE_PAGE(HID_USAGE_GEN_DESKTOP),
+			HID_USAGE(HID_USAGE_GEN_DESKTOP_X),
+			HID_USAGE(HID_USAGE_GEN_DESKTOP_Y),
+			HID_USAGE(HID_USAGE_GEN_DESKTOP_WHEEL),
+			HID_LOGICAL_MIN8(-127),
+			HID_LOGICAL_MAX8(127),
+			HID_REPORT_SIZE(8),
+			HID_REPORT_COUNT(3),
+			HID_INPUT(0x06),
+		HID_END_COLLECTION,
+	HID_END_COLLECTION,
+
+	/* Usage Page (Vendor Defined 0xFF00) */
+	HID_ITEM(HID_ITEM_TAG_USAGE_PAGE, HID_ITEM_TYPE_GLOBAL, 2), 0x00, 0xFF,
+	HID_USAGE(0x01),
+	HID_COLLECTION(HID_COLLECTION_APPLICATION),
+		HID_REPORT_ID(BOOT_TL_REPORT_ID),
+		HID_USAGE(0x02),
+		HID_LOGICAL_MIN8(0),
+		HID_LOGICAL_MAX16(0xFF, 0x00),
+		HID_REPORT_SIZE(8),
+		HID_REPORT_COUNT(BOOT_TL_REPORT_SIZE),
+		HID_FEATURE(0x02),
+	HID_END_COLLECTION,
+
+	HID_STATS_REPORT_DESC(),
+};
 
 enum mouse_report_idx {
-	MOUSE_BTN_REPORT_IDX = 0,
-	MOUSE_X_REPORT_IDX = 1,
-	MOUSE_Y_REPORT_IDX = 2,
-	MOUSE_WHEEL_REPORT_IDX = 3,
-	MOUSE_REPORT_COUNT = 4,
+	MOUSE_ID_REPORT_IDX = 0,
+	MOUSE_BTN_REPORT_IDX = 1,
+	MOUSE_X_REPORT_IDX = 2,
+	MOUSE_Y_REPORT_IDX = 3,
+	MOUSE_WHEEL_REPORT_IDX = 4,
+	MOUSE_REPORT_COUNT = 5,
 };
 
-K_MSGQ_DEFINE(mouse_msgq, MOUSE_REPORT_COUNT, 2, 1);
-static bool mouse_ready;
+/* Copy of the bootloader timeline, taken before anything can touch it */
+static struct boot_timeline boot_tl;
+/* What cpurad_boot reported about this boot, valid if boot_ho_valid */
+static struct boot_handoff boot_ho;
+static bool boot_ho_valid;
+
+static const char *const boot_reason_str[] = {
+	[BOOT_REASON_COLD] = "cold",
+	[BOOT_REASON_RESET] = "reset",
+	[BOOT_REASON_UPDATE] = "update",
+	[BOOT_REASON_ROLLBACK] = "rollback",
+};
 
-/* GPIO interrupt callback data */
-static struct gpio_callback button0_cb_data;
-static struct gpio_callback button1_cb_data;
-static struct gpio_callback button2_cb_data;
-static struct gpio_callback button3_cb_data;
+static const char *const boot_verify_str[] = {
+	[BOOT_VERIFY_NONE] = "none",
+	[BOOT_VERIFY_DIGEST] = "digest",
+	[BOOT_VERIFY_CACHED] = "cached",
+};
 
-/* GPIO interrupt handlers */
-static void button0_pressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{
-	LOG_INF("*** BUTTON0 INTERRUPT TRIGGERED! pins=0x%x ***", pins);
-	gpio_pin_toggle_dt(&led0);
-	
-	/* Send mouse event */
-	static uint8_t tmp[MOUSE_REPORT_COUNT] = {0};
-	tmp[MOUSE_BTN_REPORT_IDX] = 0x01; // Left button pressed
-	k_msgq_put(&mouse_msgq, tmp, K_NO_WAIT);
-}
+static bool mouse_ready;
+/* Counters served as the HID_STATS_REPORT_ID feature report */
+static struct hid_stats mouse_stats;
 
-static void button1_pressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{
-	LOG_INF("*** BUTTON1 INTERRUPT TRIGGERED! pins=0x%x ***", pins);
-	
-	/* Send mouse event */
-	static uint8_t tmp[MOUSE_REPORT_COUNT] = {0};
-	tmp[MOUSE_BTN_REPORT_IDX] = 0x02; // Right button pressed
-	k_msgq_put(&mouse_msgq, tmp, K_NO_WAIT);
-}
+/* Report buffers owned by the UDC from submit until input_report_done */
+#define MOUSE_REPORT_BUFS	CONFIG_HID_MOUSE_REPORT_BUFS
+#define MOUSE_REPORT_STRIDE	ROUND_UP(MOUSE_REPORT_COUNT, \
+					 MAX(UDC_BUF_GRANULARITY, sizeof(void *)))
 
-static void button2_pressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{
-	LOG_INF("*** BUTTON2 INTERRUPT TRIGGERED! pins=0x%x ***", pins);
-	
-	/* Send mouse movement event */
-	static uint8_t tmp[MOUSE_REPORT_COUNT] = {0};
-	tmp[MOUSE_X_REPORT_IDX] = 10; // Move right
-	k_msgq_put(&mouse_msgq, tmp, K_NO_WAIT);
-}
+BUILD_ASSERT(MOUSE_REPORT_BUFS <= CONFIG_USBD_HID_IN_BUF_COUNT,
+	     "usbd_hid cannot queue CONFIG_HID_MOUSE_REPORT_BUFS reports at once");
 
-static void button3_pressed(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{
-	LOG_INF("*** BUTTON3 INTERRUPT TRIGGERED! pins=0x%x ***", pins);
-	
-	/* Send mouse movement event */
-	static uint8_t tmp[MOUSE_REPORT_COUNT] = {0};
-	tmp[MOUSE_Y_REPORT_IDX] = 10; // Move down
-	k_msgq_put(&mouse_msgq, tmp, K_NO_WAIT);
-}
+UDC_STATIC_BUF_DEFINE(mouse_report_pool, MOUSE_REPORT_STRIDE * MOUSE_REPORT_BUFS);
+static struct k_mem_slab mouse_report_slab;
+static atomic_t mouse_inflight;
+
+/* Per buffer: stamp of the oldest event in the report, submit time and
+ * reports in flight including this one
+ */
+static struct {
+	uint32_t stamp;
+	uint32_t submit;
+	uint32_t depth;
+} mouse_report_meta[MOUSE_REPORT_BUFS];
 
 static void mouse_iface_ready(const struct device *dev, const bool ready)
 {
 	LOG_INF("HID device %s interface is %s",
 		dev->name, ready ? "ready" : "not ready");
 	mouse_ready = ready;
+
+	if (ready) {
+		mouse_stats.ready_up++;
+		/* Enumerated by the host: good enough to make this image the
+		 * rollback floor from the next reset on
+		 */
+		if (boot_ho_valid) {
+			boot_confirm_image();
+		}
+	} else {
+		mouse_stats.ready_down++;
+	}
+}
+
+static void mouse_report_done(const struct device *dev, const uint8_t *const report)
+{
+	int idx = (report - mouse_report_pool) / MOUSE_REPORT_STRIDE;
+
+	atomic_dec(&mouse_inflight);
+
+	if (IS_ENABLED(CONFIG_HID_MOUSE_LATENCY_BENCH)) {
+		mouse_latency_record(mouse_report_meta[idx].stamp,
+				     mouse_report_meta[idx].submit,
+				     z_arm_dwt_get_cycles(),
+				     mouse_report_meta[idx].depth);
+	}
+
+	k_mem_slab_free(&mouse_report_slab, (void *)report);
 }
 
 static int mouse_get_report(const struct device *dev,
 			 const uint8_t type, const uint8_t id, const uint16_t len,
 			 uint8_t *const buf)
 {
-	LOG_WRN("Get Report not implemented, Type %u ID %u", type, id);
+	if (type == HID_REPORT_TYPE_FEATURE && id == HID_STATS_REPORT_ID) {
+		struct mouse_ring_stats ring;
 
-	return 0;
+		mouse_ring_stats_get(&ring);
+		mouse_stats.events = ring.events;
+		mouse_stats.merged = ring.merged;
+		mouse_stats.dropped = ring.dropped;
+
+		return hid_stats_report(&mouse_stats, buf, len);
+	}
+
+	if (type != HID_REPORT_TYPE_FEATURE || id != BOOT_TL_REPORT_ID ||
+	    len < BOOT_TL_REPORT_SIZE + 1) {
+		LOG_WRN("Get Report not implemented, Type %u ID %u", type, id);
+		return 0;
+	}
+
+	buf[0] = BOOT_TL_REPORT_ID;
+	buf[1] = boot_tl.version;
+	buf[2] = boot_tl.count;
+	for (int i = 0; i < BOOT_TIMELINE_MAX; i++) {
+		buf[3 + i] = boot_tl.stage[i];
+		sys_put_le32(boot_tl.stamp[i], &buf[3 + BOOT_TIMELINE_MAX + 4 * i]);
+	}
+
+	return BOOT_TL_REPORT_SIZE + 1;
+}
+
+/*
+ * Read the record cpurad_boot leaves for the application. The image was
+ * checked against its digest before the jump, verify tells how, so the
+ * application does not check itself again.
+ */
+static void boot_handoff_take(void)
+{
+	boot_ho_valid = boot_handoff_load(&boot_ho) &&
+			boot_ho.reason <= BOOT_REASON_ROLLBACK &&
+			boot_ho.verify <= BOOT_VERIFY_CACHED;
+	if (!boot_ho_valid) {
+		LOG_INF("No boot handoff from bootloader");
+		return;
+	}
+
+	if (boot_ho.timeline_crc != boot_timeline_crc()) {
+		LOG_WRN("Boot timeline changed after the handoff");
+	}
+
+	LOG_INF("boot: %s, slot %u, v%u.%u.%u+%u, verify %s, DFU reason %u",
+		boot_reason_str[boot_ho.reason], boot_ho.slot,
+		boot_ho.image.major, boot_ho.image.minor, boot_ho.image.revision,
+		boot_ho.image.build, boot_verify_str[boot_ho.verify], boot_ho.dfu_reason);
+}
+
+/*
+ * Take over the timeline recorded by cpurad_boot, add the application
+ * main() stamp and print it in the format scripts/boot_timeline.py reads.
+ */
+static void boot_timeline_load(void)
+{
+	const volatile struct boot_timeline *tl = &boot_retained->timeline;
+	char line[BOOT_TIMELINE_MAX * 14 + 1];
+	int pos = 0;
+
+	if (!boot_timeline_is_valid(tl)) {
+		LOG_INF("No boot timeline from bootloader");
+		return;
+	}
+
+	boot_retained_read(&boot_tl, tl, sizeof(boot_tl));
+
+	/* The bootloader counted the wraps up to its last stamp */
+	boot_timeline_append(&boot_tl, BOOT_TL_APP_MAIN, z_arm_dwt_get_cycles());
+
+	for (int i = 0; i < boot_tl.count; i++) {
+		pos += snprintk(&line[pos], sizeof(line) - pos, "%s%u:%u",
+				i ? "," : "", boot_tl.stage[i], boot_tl.stamp[i]);
+	}
+
+	LOG_INF("boot_tl v%u %s", boot_tl.version, line);
 }
 
 struct hid_device_ops mouse_ops = {
 	.iface_ready = mouse_iface_ready,
+	.input_report_done = mouse_report_done,
 	.get_report = mouse_get_report,
 };
 
@@ -120,19 +273,14 @@ int main(void)
 	const struct device *hid_dev;
 	int ret;
 
-	LOG_INF("HID Mouse application started");
-
-	/* Check button GPIO devices */
-	if (!gpio_is_ready_dt(&button0)) {
-		LOG_ERR("Button0 device is not ready");
-	} else {
-		LOG_INF("Button0 device is ready");
-	}
-	if (!gpio_is_ready_dt(&button1)) {
-		LOG_ERR("Button1 device is not ready");
-	} else {
-		LOG_INF("Button1 device is ready");
+	hid_stats_init(&mouse_stats, SystemCoreClock);
+	if (IS_ENABLED(CONFIG_HID_MOUSE_LATENCY_BENCH)) {
+		mouse_latency_init(SystemCoreClock);
 	}
+	boot_handoff_take();
+	boot_timeline_load();
+
+	LOG_INF("HID Mouse application started");
 
 	if (!gpio_is_ready_dt(&led0)) {
 		LOG_ERR("LED device %s is not ready", led0.port->name);
@@ -147,83 +295,11 @@ int main(void)
 
 	LOG_INF("LED configured successfully");
 
-	/* Configure GPIO interrupts for buttons */
-	LOG_INF("Configuring GPIO interrupts...");
-	
-	// Configure button0 as input with pull-up
-	ret = gpio_pin_configure_dt(&button0, GPIO_INPUT | GPIO_PULL_UP);
-	if (ret != 0) {
-		LOG_ERR("Failed to configure button0, error: %d", ret);
-		return ret;
-	}
-	
-	// Configure button1 as input with pull-up
-	ret = gpio_pin_configure_dt(&button1, GPIO_INPUT | GPIO_PULL_UP);
-	if (ret != 0) {
-		LOG_ERR("Failed to configure button1, error: %d", ret);
-		return ret;
-	}
-	
-	// Configure button0 interrupt (active low, trigger on both edges)
-	ret = gpio_pin_interrupt_configure_dt(&button0, GPIO_INT_EDGE_BOTH);
-	if (ret != 0) {
-		LOG_ERR("Failed to configure button0 interrupt, error: %d", ret);
-		return ret;
-	}
-	
-	// Configure button1 interrupt (active low, trigger on both edges)
-	ret = gpio_pin_interrupt_configure_dt(&button1, GPIO_INT_EDGE_BOTH);
-	if (ret != 0) {
-		LOG_ERR("Failed to configure button1 interrupt, error: %d", ret);
-		return ret;
-	}
-	
-	// Configure button2 as input with pull-up
-	ret = gpio_pin_configure_dt(&button2, GPIO_INPUT | GPIO_PULL_UP);
-	if (ret != 0) {
-		LOG_ERR("Failed to configure button2, error: %d", ret);
-		return ret;
-	}
-	
-	// Configure button3 as input with pull-up
-	ret = gpio_pin_configure_dt(&button3, GPIO_INPUT | GPIO_PULL_UP);
-	if (ret != 0) {
-		LOG_ERR("Failed to configure button3, error: %d", ret);
-		return ret;
-	}
-	
-	// Configure button2 interrupt
-	ret = gpio_pin_interrupt_configure_dt(&button2, GPIO_INT_EDGE_BOTH);
+	ret = mouse_input_init(&mouse_stats);
 	if (ret != 0) {
-		LOG_ERR("Failed to configure button2 interrupt, error: %d", ret);
+		LOG_ERR("Failed to set up key input, %d", ret);
 		return ret;
 	}
-	
-	// Configure button3 interrupt
-	ret = gpio_pin_interrupt_configure_dt(&button3, GPIO_INT_EDGE_BOTH);
-	if (ret != 0) {
-		LOG_ERR("Failed to configure button3 interrupt, error: %d", ret);
-		return ret;
-	}
-	
-	// Initialize and add callbacks
-	gpio_init_callback(&button0_cb_data, button0_pressed, BIT(button0.pin));
-	gpio_add_callback(button0.port, &button0_cb_data);
-	
-	gpio_init_callback(&button1_cb_data, button1_pressed, BIT(button1.pin));
-	gpio_add_callback(button1.port, &button1_cb_data);
-	
-	gpio_init_callback(&button2_cb_data, button2_pressed, BIT(button2.pin));
-	gpio_add_callback(button2.port, &button2_cb_data);
-	
-	gpio_init_callback(&button3_cb_data, button3_pressed, BIT(button3.pin));
-	gpio_add_callback(button3.port, &button3_cb_data);
-	
-	LOG_INF("GPIO interrupts configured successfully");
-
-	/* Check if GPIOTE interrupt is enabled in NVIC */
-	// LOG_INF("Checking GPIOTE interrupt status...");
-	// LOG_INF("IRQ 105 enabled: %d", irq_is_enabled(105));
 
 	hid_dev = DEVICE_DT_GET_ONE(zephyr_hid_device);
 	if (!device_is_ready(hid_dev)) {
@@ -253,27 +329,63 @@ int main(void)
 
 	LOG_DBG("USB device support enabled");
 
-	while (true) {
-		UDC_STATIC_BUF_DEFINE(report, MOUSE_REPORT_COUNT);
+	ret = k_mem_slab_init(&mouse_report_slab, mouse_report_pool,
+			      MOUSE_REPORT_STRIDE, MOUSE_REPORT_BUFS);
+	if (ret != 0) {
+		LOG_ERR("Failed to init report buffers, %d", ret);
+		return ret;
+	}
 
-		ret = k_msgq_get(&mouse_msgq, &report, K_FOREVER);
-		if (ret != 0) {
-			LOG_ERR("Failed to get message from queue, error: %d", ret);
+	while (true) {
+		struct mouse_ring_stats stats;
+		struct mouse_evt evt;
+		uint8_t *report;
+		int idx;
+
+		/* Waits while all buffers are in flight. The report is built
+		 * only once one is free, so it holds everything queued until
+		 * then.
+		 */
+		(void)k_mem_slab_alloc(&mouse_report_slab, (void **)&report, K_FOREVER);
+
+		ret = mouse_ring_take(&evt, K_FOREVER);
+		if (ret != 0 || !mouse_ready) {
+			if (ret == 0) {
+				LOG_INF("USB HID device is not ready");
+			}
+
+			k_mem_slab_free(&mouse_report_slab, report);
 			continue;
 		}
 
-		if (!mouse_ready) {
-			LOG_INF("USB HID device is not ready");
-			continue;
-		}
+		report[MOUSE_ID_REPORT_IDX] = MOUSE_REPORT_ID;
+		report[MOUSE_BTN_REPORT_IDX] = evt.buttons;
+		report[MOUSE_X_REPORT_IDX] = evt.dx;
+		report[MOUSE_Y_REPORT_IDX] = evt.dy;
+		report[MOUSE_WHEEL_REPORT_IDX] = evt.wheel;
+
+		idx = (report - mouse_report_pool) / MOUSE_REPORT_STRIDE;
+		mouse_report_meta[idx].stamp = evt.stamp;
+		mouse_report_meta[idx].submit = z_arm_dwt_get_cycles();
+		hid_stats_latency(&mouse_stats, mouse_report_meta[idx].submit - evt.stamp);
+		mouse_report_meta[idx].depth = atomic_inc(&mouse_inflight) + 1;
 
+		/* Returns once queued, mouse_report_done() frees the buffer */
 		ret = hid_device_submit_report(hid_dev, MOUSE_REPORT_COUNT, report);
 		if (ret) {
 			LOG_ERR("HID submit report error, %d", ret);
+			mouse_stats.submit_err++;
+			atomic_dec(&mouse_inflight);
+			k_mem_slab_free(&mouse_report_slab, report);
 		} else {
+			mouse_stats.sent++;
 			/* Toggle LED on sent report */
 			(void)gpio_pin_toggle(led0.port, led0.pin);
 		}
+
+		mouse_ring_stats_get(&stats);
+		LOG_DBG("mouse events %u merged %u dropped %u",
+			stats.events, stats.merged, stats.dropped);
 	}
 
 	return 0;
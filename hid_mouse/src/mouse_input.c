@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * Every key has two more GPIO callbacks around the one of gpio-keys. The
+ * port runs callbacks from the most recently added one, so mouse_key_edge()
+ * added here after gpio-keys init runs before it, and mouse_key_exit()
+ * added at POST_KERNEL ahead of gpio-keys runs after it. Together they
+ * measure the interrupt time spent per edge and stamp the first edge of a
+ * key change, which the report latency is measured from.
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/init.h>
+#include <zephyr/input/input.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <cortex_m/dwt.h>
+
+#include "mouse_input.h"
+#include "mouse_ring.h"
+
+LOG_MODULE_REGISTER(mouse_input, LOG_LEVEL_INF);
+
+#define KEYMAP_NODE	DT_COMPAT_GET_ANY_STATUS_OKAY(rad_mouse_keymap)
+#define KEYS_NODE	DT_PHANDLE(KEYMAP_NODE, input)
+
+/* Ahead of gpio-keys, see above */
+#define MOUSE_INPUT_EXIT_INIT_PRIO	50
+
+BUILD_ASSERT(DT_NODE_HAS_COMPAT(KEYS_NODE, gpio_keys), "rad,mouse-keymap input must be gpio-keys");
+BUILD_ASSERT(MOUSE_INPUT_EXIT_INIT_PRIO < CONFIG_INPUT_INIT_PRIORITY,
+	     "exit callbacks must be added before gpio-keys");
+
+/* Same order as the action enum in rad,mouse-keymap.yaml */
+enum mouse_action {
+	MOUSE_ACTION_BUTTON_LEFT,
+	MOUSE_ACTION_BUTTON_RIGHT,
+	MOUSE_ACTION_MOVE_X,
+	MOUSE_ACTION_MOVE_Y,
+	MOUSE_ACTION_WHEEL,
+};
+
+struct mouse_key_map {
+	uint16_t code;
+	uint8_t action;
+	int8_t value;
+};
+
+struct mouse_key {
+	struct gpio_dt_spec spec;
+	uint16_t code;
+	struct gpio_callback edge_cb;
+	struct gpio_callback exit_cb;
+	/* DWT cycles at the first edge not yet reported, 0 if none */
+	atomic_t edge;
+	/* DWT cycles at the last edge, only touched from the interrupt */
+	uint32_t last;
+};
+
+#define MOUSE_KEY_MAP(node)						\
+	{								\
+		.code = DT_PROP(node, zephyr_code),			\
+		.action = DT_ENUM_IDX(node, action),			\
+		.value = (int8_t)DT_PROP(node, value),			\
+	},
+
+#define MOUSE_KEY(node)							\
+	{								\
+		.spec = GPIO_DT_SPEC_GET(node, gpios),			\
+		.code = DT_PROP(node, zephyr_code),			\
+	},
+
+static const struct mouse_key_map mouse_key_map[] = {
+	DT_FOREACH_CHILD(KEYMAP_NODE, MOUSE_KEY_MAP)
+};
+
+static struct mouse_key mouse_keys[] = {
+	DT_FOREACH_CHILD_STATUS_OKAY(KEYS_NODE, MOUSE_KEY)
+};
+
+static struct hid_stats *mouse_input_stats;
+/* gpio-keys debounce-interval-ms in DWT cycles */
+static uint32_t mouse_debounce_cyc;
+/* Edges of one port are handled one at a time, no nesting */
+static uint32_t mouse_isr_start;
+/* Button bits of the report, only touched from the input thread */
+static uint8_t mouse_buttons;
+
+static void mouse_key_edge(const struct device *port, struct gpio_callback *cb, uint32_t pins)
+{
+	struct mouse_key *key = CONTAINER_OF(cb, struct mouse_key, edge_cb);
+	uint32_t now = z_arm_dwt_get_cycles();
+	uint32_t idle = now - key->last;
+
+	mouse_isr_start = now;
+	key->last = now;
+
+	/* gpio-keys reports a change one debounce interval after its last
+	 * edge. Past that, a stamp still latched belongs to a bounce it
+	 * dropped without an event and this edge starts a new change.
+	 */
+	if (idle > mouse_debounce_cyc) {
+		(void)atomic_set(&key->edge, now ? now : 1);
+	} else {
+		(void)atomic_cas(&key->edge, 0, now ? now : 1);
+	}
+}
+
+static void mouse_key_exit(const struct device *port, struct gpio_callback *cb, uint32_t pins)
+{
+	if (mouse_input_stats != NULL) {
+		hid_stats_isr(mouse_input_stats, z_arm_dwt_get_cycles() - mouse_isr_start);
+	}
+}
+
+/* First edge of the change being reported, now if it was not seen */
+static uint32_t mouse_key_edge_take(uint16_t code)
+{
+	for (int i = 0; i < ARRAY_SIZE(mouse_keys); i++) {
+		if (mouse_keys[i].code == code) {
+			atomic_val_t edge = atomic_set(&mouse_keys[i].edge, 0);
+
+			if (edge != 0) {
+				return edge;
+			}
+		}
+	}
+
+	return z_arm_dwt_get_cycles();
+}
+
+static void mouse_input_cb(struct input_event *evt, void *user_data)
+{
+	struct mouse_evt m = { 0 };
+	uint8_t buttons = mouse_buttons;
+	bool mapped = false;
+
+	ARG_UNUSED(user_data);
+
+	if (evt->type != INPUT_EV_KEY) {
+		return;
+	}
+
+	m.stamp = mouse_key_edge_take(evt->code);
+
+	for (int i = 0; i < ARRAY_SIZE(mouse_key_map); i++) {
+		const struct mouse_key_map *map = &mouse_key_map[i];
+		int8_t value = evt->value ? map->value : 0;
+
+		if (map->code != evt->code) {
+			continue;
+		}
+
+		mapped = true;
+		switch (map->action) {
+		case MOUSE_ACTION_BUTTON_LEFT:
+			WRITE_BIT(buttons, MOUSE_BTN_LEFT, evt->value);
+			break;
+		case MOUSE_ACTION_BUTTON_RIGHT:
+			WRITE_BIT(buttons, MOUSE_BTN_RIGHT, evt->value);
+			break;
+		case MOUSE_ACTION_MOVE_X:
+			m.dx += value;
+			break;
+		case MOUSE_ACTION_MOVE_Y:
+			m.dy += value;
+			break;
+		case MOUSE_ACTION_WHEEL:
+			m.wheel += value;
+			break;
+		}
+	}
+
+	if (!mapped) {
+		LOG_DBG("Unmapped key %u", evt->code);
+		return;
+	}
+
+	LOG_DBG("Key %u %s", evt->code, evt->value ? "pressed" : "released");
+
+	/* A release of a motion key changes nothing */
+	if (buttons == mouse_buttons && m.dx == 0 && m.dy == 0 && m.wheel == 0) {
+		return;
+	}
+
+	mouse_buttons = buttons;
+	m.buttons = buttons;
+	mouse_ring_put(&m);
+}
+
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(KEYS_NODE), mouse_input_cb, NULL);
+
+static int mouse_input_add_callbacks(bool edge)
+{
+	for (int i = 0; i < ARRAY_SIZE(mouse_keys); i++) {
+		struct mouse_key *key = &mouse_keys[i];
+		struct gpio_callback *cb = edge ? &key->edge_cb : &key->exit_cb;
+		int err;
+
+		if (!gpio_is_ready_dt(&key->spec)) {
+			return -ENODEV;
+		}
+
+		gpio_init_callback(cb, edge ? mouse_key_edge : mouse_key_exit,
+				   BIT(key->spec.pin));
+		err = gpio_add_callback_dt(&key->spec, cb);
+		if (err != 0) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static int mouse_input_exit_init(void)
+{
+	return mouse_input_add_callbacks(false);
+}
+
+SYS_INIT(mouse_input_exit_init, POST_KERNEL, MOUSE_INPUT_EXIT_INIT_PRIO);
+
+int mouse_input_init(struct hid_stats *stats)
+{
+	mouse_input_stats = stats;
+	mouse_debounce_cyc = (uint32_t)(((uint64_t)DT_PROP(KEYS_NODE, debounce_interval_ms) *
+					 SystemCoreClock) / MSEC_PER_SEC);
+
+	return mouse_input_add_callbacks(true);
+}
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef H_MOUSE_INPUT_
+#define H_MOUSE_INPUT_
+
+#include <hid_stats.h>
+
+/*
+ * Keys to mouse events. gpio-keys debounces the buttons and reports press
+ * and release through the input subsystem; the rad,mouse-keymap node maps
+ * each key code to a report action. Events reach the ring from the input
+ * thread, nothing but two cycle counter reads runs in the GPIO interrupt.
+ */
+
+/**
+ * Start stamping key edges. ISR time per edge is added to @p stats from
+ * then on.
+ */
+int mouse_input_init(struct hid_stats *stats);
+
+#endif
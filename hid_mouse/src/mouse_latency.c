@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/*
+ * GPIO edge to report latency. Every CONFIG_HID_MOUSE_LATENCY_SAMPLES
+ * reports a summary is logged: min/avg/max from the GPIO interrupt to the
+ * submit call and to the report being polled by the host, from submit to
+ * completion, the number of reports in flight at submit, and a histogram
+ * of the GPIO to poll latency in polling periods. Reports merged from
+ * several events count from the oldest one.
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/logging/log.h>
+
+#include "mouse_latency.h"
+
+LOG_MODULE_REGISTER(mouse_latency, LOG_LEVEL_INF);
+
+#define LAT_POLL_US	DT_PROP(DT_NODELABEL(hid_dev_0), in_polling_period_us)
+
+static struct mouse_latency_summary lat;
+static uint32_t lat_cycles_per_sec;
+
+static uint32_t lat_cyc_to_us(uint32_t cycles)
+{
+	return (uint32_t)(((uint64_t)cycles * USEC_PER_SEC) / lat_cycles_per_sec);
+}
+
+void mouse_latency_init(uint32_t cycles_per_sec)
+{
+	memset(&lat, 0, sizeof(lat));
+	lat_cycles_per_sec = cycles_per_sec;
+}
+
+static void lat_stat_add(struct mouse_latency_stat *st, uint32_t v)
+{
+	if (lat.count == 0 || v < st->min) {
+		st->min = v;
+	}
+
+	st->max = MAX(st->max, v);
+	st->sum += v;
+}
+
+void mouse_latency_record(uint32_t stamp, uint32_t submit, uint32_t done, uint32_t depth)
+{
+	uint32_t submit_us = lat_cyc_to_us(submit - stamp);
+	uint32_t done_us = lat_cyc_to_us(done - stamp);
+
+	lat_stat_add(&lat.submit, submit_us);
+	lat_stat_add(&lat.done, done_us);
+	lat_stat_add(&lat.complete, lat_cyc_to_us(done - submit));
+	lat_stat_add(&lat.depth, depth);
+	lat.hist[MIN(done_us / LAT_POLL_US, MOUSE_LATENCY_BUCKETS - 1)]++;
+
+	if (++lat.count < CONFIG_HID_MOUSE_LATENCY_SAMPLES) {
+		return;
+	}
+
+	LOG_INF("[lat] poll %u us, %u reports: submit %u/%u/%u us, polled %u/%u/%u us",
+		LAT_POLL_US, lat.count,
+		lat.submit.min, (uint32_t)(lat.submit.sum / lat.count), lat.submit.max,
+		lat.done.min, (uint32_t)(lat.done.sum / lat.count), lat.done.max);
+	LOG_INF("[lat] submit to complete %u/%u/%u us, in flight %u/%u/%u",
+		lat.complete.min, (uint32_t)(lat.complete.sum / lat.count), lat.complete.max,
+		lat.depth.min, (uint32_t)(lat.depth.sum / lat.count), lat.depth.max);
+	LOG_INF("[lat] polled within 1..%u+ periods: %u %u %u %u %u %u %u %u",
+		MOUSE_LATENCY_BUCKETS, lat.hist[0], lat.hist[1], lat.hist[2], lat.hist[3],
+		lat.hist[4], lat.hist[5], lat.hist[6], lat.hist[7]);
+
+	memset(&lat, 0, sizeof(lat));
+}
+
+#ifdef CONFIG_ZTEST
+const struct mouse_latency_summary *mouse_latency_test_summary(void)
+{
+	return &lat;
+}
+#endif
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef H_MOUSE_LATENCY_
+#define H_MOUSE_LATENCY_
+
+#include <stdint.h>
+
+/* Last bucket also counts everything later */
+#define MOUSE_LATENCY_BUCKETS	8
+
+struct mouse_latency_stat {
+	uint32_t min;
+	uint32_t max;
+	uint64_t sum;
+};
+
+/* Running summary in microseconds, logged and cleared every
+ * CONFIG_HID_MOUSE_LATENCY_SAMPLES reports. hist[n] counts reports polled
+ * within n + 1 polling periods of the GPIO edge.
+ */
+struct mouse_latency_summary {
+	uint32_t count;
+	struct mouse_latency_stat submit;
+	struct mouse_latency_stat done;
+	struct mouse_latency_stat complete;
+	struct mouse_latency_stat depth;
+	uint32_t hist[MOUSE_LATENCY_BUCKETS];
+};
+
+/**
+ * Start the benchmark with an empty summary. @p cycles_per_sec is the
+ * rate of the DWT cycle counter the stamps are taken from.
+ */
+void mouse_latency_init(uint32_t cycles_per_sec);
+
+/**
+ * Record one report of the GPIO edge to report latency benchmark
+ * (CONFIG_HID_MOUSE_LATENCY_BENCH). All arguments are DWT cycles.
+ *
+ * @param stamp GPIO interrupt of the oldest event in the report
+ * @param submit hid_device_submit_report() called
+ * @param done input_report_done, the host has polled the report
+ * @param depth Reports in flight at submit, including this one
+ */
+void mouse_latency_record(uint32_t stamp, uint32_t submit, uint32_t done, uint32_t depth);
+
+#ifdef CONFIG_ZTEST
+/**
+ * Test only: the summary of the current period.
+ */
+const struct mouse_latency_summary *mouse_latency_test_summary(void);
+#endif
+
+#endif
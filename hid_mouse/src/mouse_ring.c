@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+
+#include "mouse_ring.h"
+
+#define MOUSE_RING_SIZE		16
+#define MOUSE_RING_MASK		(MOUSE_RING_SIZE - 1)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(MOUSE_RING_SIZE), "MOUSE_RING_SIZE must be a power of two");
+
+static struct mouse_evt mouse_ring[MOUSE_RING_SIZE];
+/* Free running indexes, head written by the producer, tail by the consumer */
+static atomic_t mouse_ring_head;
+static atomic_t mouse_ring_tail;
+
+/* Events that found the ring full, and every event after them until the
+ * consumer has collected them: motion added up, the latest button state
+ * with MOUSE_OVF_PENDING set
+ */
+#define MOUSE_OVF_PENDING	BIT(8)
+
+static atomic_t mouse_ovf_buttons;
+static atomic_t mouse_ovf_dx;
+static atomic_t mouse_ovf_dy;
+static atomic_t mouse_ovf_wheel;
+static atomic_t mouse_ovf_stamp;
+
+static atomic_t mouse_stat_events;
+static atomic_t mouse_stat_merged;
+static atomic_t mouse_stat_dropped;
+
+static K_SEM_DEFINE(mouse_ring_sem, 0, 1);
+
+/* Consumer side accumulator, not yet reported */
+static struct {
+	int32_t dx;
+	int32_t dy;
+	int32_t wheel;
+	uint32_t stamp;
+	uint8_t buttons;
+	bool pending;
+} mouse_acc;
+
+void mouse_ring_put(const struct mouse_evt *evt)
+{
+	atomic_val_t head = atomic_get(&mouse_ring_head);
+
+	atomic_inc(&mouse_stat_events);
+
+	/* Once overflowed, stay there so nothing overtakes the overflow */
+	if (atomic_get(&mouse_ovf_buttons) != 0 ||
+	    (atomic_val_t)(head - atomic_get(&mouse_ring_tail)) >= MOUSE_RING_SIZE) {
+		atomic_add(&mouse_ovf_dx, evt->dx);
+		atomic_add(&mouse_ovf_dy, evt->dy);
+		atomic_add(&mouse_ovf_wheel, evt->wheel);
+		(void)atomic_cas(&mouse_ovf_stamp, 0, evt->stamp);
+		atomic_set(&mouse_ovf_buttons, MOUSE_OVF_PENDING | evt->buttons);
+		atomic_inc(&mouse_stat_dropped);
+	} else {
+		mouse_ring[head & MOUSE_RING_MASK] = *evt;
+		/* Publishes the slot, atomic_set() is a full barrier */
+		atomic_set(&mouse_ring_head, head + 1);
+	}
+
+	k_sem_give(&mouse_ring_sem);
+}
+
+static bool mouse_ring_idle(void)
+{
+	return !mouse_acc.pending &&
+	       atomic_get(&mouse_ring_head) == atomic_get(&mouse_ring_tail) &&
+	       atomic_get(&mouse_ovf_buttons) == 0 &&
+	       atomic_get(&mouse_ovf_dx) == 0 &&
+	       atomic_get(&mouse_ovf_dy) == 0 &&
+	       atomic_get(&mouse_ovf_wheel) == 0;
+}
+
+static int8_t mouse_clamp(int32_t *acc)
+{
+	int32_t v = CLAMP(*acc, -127, 127);
+
+	*acc -= v;
+
+	return (int8_t)v;
+}
+
+/* Fold the overflow into the accumulator. Only called with the ring
+ * drained, everything in the overflow is newer than what was in it.
+ */
+static void mouse_ovf_take(void)
+{
+	atomic_val_t ovf;
+	atomic_val_t stamp;
+
+	do {
+		ovf = atomic_get(&mouse_ovf_buttons);
+
+		/* A button change is reported on its own */
+		if (ovf != 0 && mouse_acc.pending &&
+		    (uint8_t)ovf != mouse_acc.buttons) {
+			return;
+		}
+	} while (ovf != 0 && !atomic_cas(&mouse_ovf_buttons, ovf, 0));
+
+	stamp = atomic_set(&mouse_ovf_stamp, 0);
+	if (!mouse_acc.pending && stamp != 0) {
+		mouse_acc.stamp = stamp;
+	}
+
+	if (ovf != 0) {
+		mouse_acc.buttons = (uint8_t)ovf;
+		mouse_acc.pending = true;
+	}
+
+	mouse_acc.dx += atomic_set(&mouse_ovf_dx, 0);
+	mouse_acc.dy += atomic_set(&mouse_ovf_dy, 0);
+	mouse_acc.wheel += atomic_set(&mouse_ovf_wheel, 0);
+}
+
+int mouse_ring_take(struct mouse_evt *out, k_timeout_t timeout)
+{
+	atomic_val_t tail = atomic_get(&mouse_ring_tail);
+
+	while (mouse_ring_idle()) {
+		if (k_sem_take(&mouse_ring_sem, timeout) != 0) {
+			return -EAGAIN;
+		}
+	}
+
+	while (tail != atomic_get(&mouse_ring_head)) {
+		const struct mouse_evt *evt = &mouse_ring[tail & MOUSE_RING_MASK];
+
+		/* A button change is reported on its own */
+		if (mouse_acc.pending && evt->buttons != mouse_acc.buttons) {
+			break;
+		}
+
+		if (mouse_acc.pending) {
+			atomic_inc(&mouse_stat_merged);
+		} else {
+			mouse_acc.stamp = evt->stamp;
+		}
+
+		mouse_acc.buttons = evt->buttons;
+		mouse_acc.dx += evt->dx;
+		mouse_acc.dy += evt->dy;
+		mouse_acc.wheel += evt->wheel;
+		mouse_acc.pending = true;
+
+		tail++;
+		atomic_set(&mouse_ring_tail, tail);
+	}
+
+	if (tail == atomic_get(&mouse_ring_head)) {
+		mouse_ovf_take();
+	}
+
+	out->buttons = mouse_acc.buttons;
+	out->dx = mouse_clamp(&mouse_acc.dx);
+	out->dy = mouse_clamp(&mouse_acc.dy);
+	out->wheel = mouse_clamp(&mouse_acc.wheel);
+	out->stamp = mouse_acc.stamp;
+
+	mouse_acc.pending = mouse_acc.dx != 0 || mouse_acc.dy != 0 || mouse_acc.wheel != 0;
+
+	return 0;
+}
+
+void mouse_ring_stats_get(struct mouse_ring_stats *stats)
+{
+	stats->events = atomic_get(&mouse_stat_events);
+	stats->merged = atomic_get(&mouse_stat_merged);
+	stats->dropped = atomic_get(&mouse_stat_dropped);
+}
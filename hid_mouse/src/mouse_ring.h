@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef H_MOUSE_RING_
+#define H_MOUSE_RING_
+
+#include <stdint.h>
+#include <zephyr/kernel.h>
+
+/*
+ * Mouse input from interrupt context to the report loop.
+ *
+ * Events go through a lock-free single producer, single consumer ring:
+ * the input callback in mouse_input.c is the only writer, the report loop
+ * the only reader. The reader merges every event with the same button
+ * state into one report, so a report carries all motion up to the moment
+ * it is built. A button change always starts a new report. When the ring
+ * is full, events go to an overflow state instead, and so does every later
+ * event until the reader has drained the ring and collected the overflow.
+ * Their motion is added up and the latest button state is kept, so only
+ * button states in between are lost.
+ */
+
+/* Bits in mouse_evt.buttons and the report */
+#define MOUSE_BTN_LEFT		0
+#define MOUSE_BTN_RIGHT		1
+
+struct mouse_evt {
+	/* Button bits, as in the report */
+	uint8_t buttons;
+	int8_t dx;
+	int8_t dy;
+	int8_t wheel;
+	/* DWT cycles at the first GPIO edge of the key change. In a report from mouse_ring_take()
+	 * the stamp of the oldest event it carries.
+	 */
+	uint32_t stamp;
+};
+
+struct mouse_ring_stats {
+	/* Events put into the ring */
+	uint32_t events;
+	/* Events folded into a report together with an earlier one */
+	uint32_t merged;
+	/* Events that went to the overflow, motion and last button state kept */
+	uint32_t dropped;
+};
+
+/**
+ * Queue an event. A single producer only, may run in interrupt context.
+ */
+void mouse_ring_put(const struct mouse_evt *evt);
+
+/**
+ * Build the next report from everything queued so far.
+ *
+ * Motion beyond the int8_t range of a report stays behind for the next
+ * one, which is then available right away.
+ *
+ * @retval 0 @p out holds a report
+ * @retval -EAGAIN nothing arrived within @p timeout
+ */
+int mouse_ring_take(struct mouse_evt *out, k_timeout_t timeout);
+
+void mouse_ring_stats_get(struct mouse_ring_stats *stats);
+
+#endif
@@ -4,10 +4,69 @@
 set (TARGET_BOARD "nrf54h20dk/nrf54h20/cpurad")
 
 if(SB_CONFIG_RAD_BOOT)
+  set(RAD_BOOT_DIR ${APP_DIR}/../cpurad_boot)
+  # Bootloader images, Kconfig choices below apply to all of them
+  set(RAD_BOOT_IMAGES cpurad_boot)
+
+  if(SB_CONFIG_RAD_BOOT_TWO_STAGE)
+    set(cpurad_boot_EXTRA_CONF_FILE
+        ${RAD_BOOT_DIR}/stage0.conf CACHE INTERNAL "")
+    set(cpurad_boot_EXTRA_DTC_OVERLAY_FILE
+        ${RAD_BOOT_DIR}/sysbuild/stage0.overlay CACHE INTERNAL "")
+
+    # Same bootloader with USB and DFU, linked for cpurad_stage1_partition
+    # behind an image header
+    set(cpurad_boot_stage1_EXTRA_CONF_FILE
+        ${RAD_BOOT_DIR}/stage1.conf CACHE INTERNAL "")
+    set(cpurad_boot_stage1_EXTRA_DTC_OVERLAY_FILE
+        ${RAD_BOOT_DIR}/sysbuild/stage1.overlay CACHE INTERNAL "")
+    ExternalZephyrProject_Add(
+      APPLICATION cpurad_boot_stage1
+      SOURCE_DIR ${RAD_BOOT_DIR}
+      BOARD ${TARGET_BOARD}
+    )
+    list(APPEND RAD_BOOT_IMAGES cpurad_boot_stage1)
+  endif()
+
   ExternalZephyrProject_Add(
     APPLICATION cpurad_boot
-    SOURCE_DIR ${APP_DIR}/../cpurad_boot
+    SOURCE_DIR ${RAD_BOOT_DIR}
     BOARD ${TARGET_BOARD}
   )
-endif()
 
+  if(SB_CONFIG_RAD_BOOT_XIP_AB)
+    foreach(image ${RAD_BOOT_IMAGES})
+      set_config_bool(${image} CONFIG_RAD_BOOT_XIP_AB y)
+    endforeach()
+
+    # Same application, linked to run from cpurad_app2_partition
+    set(hid_mouse_slot2_EXTRA_DTC_OVERLAY_FILE
+        ${APP_DIR}/sysbuild/hid_mouse_slot2.overlay CACHE INTERNAL "")
+    ExternalZephyrProject_Add(
+      APPLICATION hid_mouse_slot2
+      SOURCE_DIR ${APP_DIR}
+      BOARD ${TARGET_BOARD}
+    )
+  elseif(SB_CONFIG_RAD_BOOT_SWAP)
+    foreach(image ${RAD_BOOT_IMAGES})
+      set_config_bool(${image} CONFIG_RAD_BOOT_SWAP y)
+    endforeach()
+  else()
+    foreach(image ${RAD_BOOT_IMAGES})
+      set_config_bool(${image} CONFIG_RAD_BOOT_SINGLE_SLOT y)
+    endforeach()
+  endif()
+
+  if(NOT "${SB_CONFIG_RAD_BOOT_SIGNATURE_KEY}" STREQUAL "")
+    get_filename_component(RAD_SIGNATURE_KEY ${SB_CONFIG_RAD_BOOT_SIGNATURE_KEY}
+                           ABSOLUTE BASE_DIR ${APP_DIR})
+    foreach(image ${RAD_BOOT_IMAGES})
+      set_config_bool(${image} CONFIG_RAD_BOOT_SIGNATURE y)
+      set_config_string(${image} CONFIG_RAD_BOOT_SIGNATURE_KEY ${RAD_SIGNATURE_KEY})
+    endforeach()
+    set_config_string(hid_mouse CONFIG_RAD_IMAGE_SIGNING_KEY ${RAD_SIGNATURE_KEY})
+    if(SB_CONFIG_RAD_BOOT_XIP_AB)
+      set_config_string(hid_mouse_slot2 CONFIG_RAD_IMAGE_SIGNING_KEY ${RAD_SIGNATURE_KEY})
+    endif()
+  endif()
+endif()
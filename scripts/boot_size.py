@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+#
+"""Compare the cpurad_boot footprint of sysbuild build directories.
+
+For every bootloader image found in a build directory (cpurad_boot and,
+with SB_CONFIG_RAD_BOOT_TWO_STAGE, cpurad_boot_stage1) the size of
+zephyr.bin is printed against the partition the image is linked for.
+Pass a single-image and a two-stage build to see what stage-0 costs on
+the fast path:
+
+    boot_size.py build-single build-two-stage
+"""
+
+import argparse
+import os
+import re
+import sys
+
+IMAGES = ["cpurad_boot", "cpurad_boot_stage1"]
+CONFIG_RE = re.compile(r"^(CONFIG_FLASH_LOAD_(?:OFFSET|SIZE))=(\S+)$")
+
+
+def image_size(build, image):
+    """Return (bin size, partition offset, partition size) or None."""
+    zephyr = os.path.join(build, image, "zephyr")
+    try:
+        size = os.path.getsize(os.path.join(zephyr, "zephyr.bin"))
+    except OSError:
+        return None
+
+    config = {}
+    with open(os.path.join(zephyr, ".config")) as f:
+        for line in f:
+            m = CONFIG_RE.match(line.strip())
+            if m:
+                config[m.group(1)] = int(m.group(2), 0)
+    return size, config.get("CONFIG_FLASH_LOAD_OFFSET", 0), config.get("CONFIG_FLASH_LOAD_SIZE", 0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("build", nargs="+", help="sysbuild build directory")
+    args = parser.parse_args()
+
+    first = None
+    for build in args.build:
+        print(build)
+        fast_path = None
+        for image in IMAGES:
+            sizes = image_size(build, image)
+            if sizes is None:
+                continue
+            size, offset, part = sizes
+            used = f"{size * 100 / part:5.1f}%" if part else "     ?"
+            print(f"  {image:<20} {size:7d} bytes  {used} of {part // 1024}KB @ 0x{offset:x}")
+            if fast_path is None:
+                # The image that runs on every reset
+                fast_path = size
+        if fast_path is None:
+            sys.exit(f"{build}: no cpurad_boot image found")
+        if first is None:
+            first = fast_path
+        else:
+            print(f"  fast path {fast_path - first:+d} bytes against {args.build[0]}")
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+#
+"""Decode the cpurad_boot boot timeline.
+
+The timeline is read either from the hid_mouse console log line
+
+    boot_tl v2 0:0,1:1234,2:5678,...
+
+with stage:microseconds entries in the order the stages were marked, or
+from the vendor feature report (ID 2) of the running hid_mouse device.
+Use --json to store a decoded timeline and --baseline to compare a build
+against a previously stored one.
+"""
+
+import argparse
+import json
+import re
+import struct
+import sys
+
+# Must follow enum boot_tl_stage in common/include/boot_timeline.h
+STAGES = [
+    "early init",
+    "main",
+    "boot decision",
+    "USB init",
+    "DFU session",
+    "USB shutdown",
+    "periph cleanup",
+    "NVIC cleanup",
+    "cache flush",
+    "jump",
+    "app main",
+    "USB disconnect",
+    "USB core reset",
+    "stage-1 start",
+]
+
+BOOT_TL_REPORT_ID = 2
+BOOT_TIMELINE_MAX = 16
+LOG_RE = re.compile(r"boot_tl v(\d+) ([\d:,]+)")
+
+
+def from_log(path):
+    with open(path, errors="replace") as f:
+        for line in f:
+            m = LOG_RE.search(line)
+            if m:
+                entries = [tuple(int(v) for v in e.split(":"))
+                           for e in m.group(2).split(",")]
+                return int(m.group(1)), entries
+    sys.exit(f"No boot_tl line found in {path}")
+
+
+def from_hid(vid, pid):
+    import hid
+
+    dev = hid.device()
+    dev.open(vid, pid)
+    data = bytes(dev.get_feature_report(BOOT_TL_REPORT_ID,
+                                        3 + 5 * BOOT_TIMELINE_MAX))
+    dev.close()
+    version, count = struct.unpack_from("<BB", data, 1)
+    stages = data[3:3 + BOOT_TIMELINE_MAX]
+    stamps = struct.unpack_from(f"<{BOOT_TIMELINE_MAX}I", data, 3 + BOOT_TIMELINE_MAX)
+    return version, list(zip(stages, stamps))[:count]
+
+
+def decode(entries):
+    """Return {stage: (absolute us, delta us)} for every stage reached, in
+    the order the stages were marked."""
+    result = {}
+    prev = 0
+    for i, stamp in entries:
+        name = STAGES[i] if i < len(STAGES) else f"stage {i}"
+        result[name] = (stamp, stamp - prev)
+        prev = stamp
+    return result
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    src = parser.add_mutually_exclusive_group(required=True)
+    src.add_argument("--log", help="console log containing the boot_tl line")
+    src.add_argument("--hid", metavar="VID:PID",
+                     help="read the feature report from a device (needs hidapi)")
+    parser.add_argument("--json", help="write the decoded timeline to this file")
+    parser.add_argument("--baseline", help="JSON file from a previous build to compare with")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="percent slowdown of a stage reported as regression")
+    args = parser.parse_args()
+
+    if args.log:
+        version, entries = from_log(args.log)
+    else:
+        vid, pid = (int(v, 16) for v in args.hid.split(":"))
+        version, entries = from_hid(vid, pid)
+
+    timeline = decode(entries)
+    baseline = {}
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)["stages"]
+
+    print(f"boot timeline v{version}")
+    regressions = 0
+    for name, (abs_us, delta_us) in timeline.items():
+        line = f"  {name:<16} {abs_us:10d} us  +{delta_us:9d} us"
+        if name in baseline:
+            ref = baseline[name][1]
+            diff = delta_us - ref
+            line += f"  ({diff:+.1f} us)"
+            if ref > 0 and diff * 100 / ref > args.threshold:
+                line += "  REGRESSION"
+                regressions += 1
+        print(line)
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump({"version": version, "stages": timeline}, f, indent=2)
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
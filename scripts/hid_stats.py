@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+#
+"""Poll the input statistics feature report of hid_mouse or cpurad_boot.
+
+The report (ID 5, common/include/hid_stats.h) is read over plain HID, so
+no debug probe is needed. Every interval the tool prints the counters,
+their rate since the previous read, the ISR time and the GPIO interrupt
+to report submit histogram converted to microseconds.
+
+Needs hidapi. Devices attached through USB/IP show up like local ones.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+HID_STATS_REPORT_ID = 5
+HID_STATS_USAGE_PAGE = 0xFF01
+HID_STATS_VERSION = 1
+HID_STATS_HIST_BUCKETS = 16
+
+# version, hist_shift, hist_buckets, cycles_per_sec, events, sent, merged,
+# dropped, submit_err, ready_up, ready_down, isr_count, isr_cycles_max,
+# isr_cycles_sum, hist
+STATS_FMT = f"<BBHIIIIIIIIIIQ{HID_STATS_HIST_BUCKETS}I"
+STATS_SIZE = struct.calcsize(STATS_FMT)
+COUNTERS = ["events", "sent", "merged", "dropped", "submit_err",
+            "ready_up", "ready_down", "isr_count"]
+
+# CONFIG_SAMPLE_USBD_VID / CONFIG_SAMPLE_USBD_PID of both images
+DEFAULT_VID = 0x2FE3
+DEFAULT_PID = 0x0007
+
+
+def open_device(vid, pid):
+    import hid
+
+    entries = hid.enumerate(vid, pid)
+    if not entries:
+        sys.exit(f"no HID device {vid:04x}:{pid:04x} found")
+    # Where the OS splits top level collections, open the statistics one
+    entry = next((e for e in entries if e.get("usage_page") == HID_STATS_USAGE_PAGE),
+                 entries[0])
+
+    dev = hid.device()
+    dev.open_path(entry["path"])
+    return dev
+
+
+def read_stats(dev):
+    data = bytes(dev.get_feature_report(HID_STATS_REPORT_ID, 1 + STATS_SIZE))
+    if len(data) < 1 + STATS_SIZE:
+        sys.exit(f"short statistics report ({len(data)} bytes)")
+
+    values = struct.unpack_from(STATS_FMT, data, 1)
+    stats = dict(zip(["version", "hist_shift", "hist_buckets", "hz"] + COUNTERS +
+                     ["isr_cycles_max", "isr_cycles_sum"], values))
+    if stats["version"] != HID_STATS_VERSION:
+        sys.exit(f"unsupported statistics version {stats['version']}")
+    stats["hist"] = list(values[-HID_STATS_HIST_BUCKETS:])
+    return stats
+
+
+def bucket_us(stats, i):
+    """Upper bound of histogram bucket i in us, None for the last one."""
+    if i == stats["hist_buckets"] - 1:
+        return None
+    return (1 << (stats["hist_shift"] + i)) * 1e6 / stats["hz"]
+
+
+def show(stats, prev, elapsed):
+    hz = stats["hz"]
+    line = []
+    for name in COUNTERS:
+        rate = ""
+        if prev is not None and elapsed > 0:
+            rate = f" ({(stats[name] - prev[name]) / elapsed:.0f}/s)"
+        line.append(f"{name} {stats[name]}{rate}")
+    print(", ".join(line))
+
+    if stats["isr_count"]:
+        avg = stats["isr_cycles_sum"] / stats["isr_count"]
+        print(f"  ISR avg {avg * 1e6 / hz:.2f} us, max {stats['isr_cycles_max'] * 1e6 / hz:.2f} us")
+
+    hist = stats["hist"]
+    if prev is not None:
+        hist = [a - b for a, b in zip(hist, prev["hist"])]
+    total = sum(hist)
+    if total == 0:
+        return
+
+    print(f"  GPIO to submit, {total} reports:")
+    for i, count in enumerate(hist):
+        if count == 0:
+            continue
+        upper = bucket_us(stats, i)
+        label = f"< {upper:9.1f} us" if upper is not None else f">= {bucket_us(stats, i - 1):8.1f} us"
+        print(f"    {label}  {count:8}  {count * 100 / total:5.1f}%")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--vid", type=lambda v: int(v, 16), default=DEFAULT_VID)
+    parser.add_argument("--pid", type=lambda v: int(v, 16), default=DEFAULT_PID)
+    parser.add_argument("--interval", type=float, default=1.0,
+                        help="seconds between reads, the histogram shows the difference")
+    parser.add_argument("--count", type=int, default=0,
+                        help="number of reads, 0 to poll until interrupted")
+    args = parser.parse_args()
+
+    dev = open_device(args.vid, args.pid)
+    prev = None
+    prev_time = time.monotonic()
+    n = 0
+    try:
+        while True:
+            stats = read_stats(dev)
+            now = time.monotonic()
+            show(stats, prev, now - prev_time)
+            prev, prev_time = stats, now
+
+            n += 1
+            if args.count and n >= args.count:
+                break
+            time.sleep(args.interval)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        dev.close()
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
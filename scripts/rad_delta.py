@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+#
+"""Generate a cpurad_boot delta patch between two zephyr.rad.bin files.
+
+The patch rebuilds NEW from OLD, the image the device currently has in the
+slot the patch is read from. The format follows cpurad_boot/include/delta.h.
+The patch is applied to OLD again before it is written, so a patch that
+does not rebuild NEW byte for byte is never produced.
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+
+from rad_image import HEADER_FMT, IMAGE_MAGIC
+
+DELTA_MAGIC = 0x544C4452
+DELTA_HDR_FMT = "<III32s"
+DELTA_OP_FMT = "<B3xII"
+DELTA_OP_COPY = 1
+DELTA_OP_INSERT = 2
+
+# Matches shorter than this cost more as a COPY op than as literal bytes
+BLOCK = 16
+# OLD is indexed at this stride; any match of BLOCK + STEP - 1 bytes is found
+STEP = 4
+
+
+def image_info(data, name):
+    """Return (header + image size, image SHA-256) of a zephyr.rad.bin."""
+    hdr_len = struct.calcsize(HEADER_FMT)
+    if len(data) < hdr_len:
+        sys.exit(f"{name}: too short for an image header")
+    magic, hdr_size, _, img_size, *_, sha256 = struct.unpack_from(HEADER_FMT, data)
+    if magic != IMAGE_MAGIC or hdr_size + img_size > len(data):
+        sys.exit(f"{name}: no valid image header")
+    return hdr_size + img_size, sha256
+
+
+def match_len(old, j, new, i):
+    n = 0
+    limit = min(len(old) - j, len(new) - i)
+    # Compare in large steps first, bytes are only compared at the end
+    step = 256
+    while n + step <= limit and old[j + n:j + n + step] == new[i + n:i + n + step]:
+        n += step
+    while n < limit and old[j + n] == new[i + n]:
+        n += 1
+    return n
+
+
+def diff(old, new):
+    index = {}
+    for off in range(0, len(old) - BLOCK + 1, STEP):
+        index.setdefault(old[off:off + BLOCK], off)
+
+    ops = []
+    lit = 0
+    i = 0
+    shift = None
+    while i + BLOCK <= len(new):
+        key = new[i:i + BLOCK]
+        j = None
+        # Unchanged code after an edit usually continues at the same shift
+        if shift is not None and 0 <= i + shift <= len(old) - BLOCK and \
+                old[i + shift:i + shift + BLOCK] == key:
+            j = i + shift
+        if j is None:
+            j = index.get(key)
+        if j is None:
+            i += 1
+            continue
+
+        while i > lit and j > 0 and new[i - 1] == old[j - 1]:
+            i -= 1
+            j -= 1
+
+        n = match_len(old, j, new, i)
+        if i > lit:
+            ops.append((DELTA_OP_INSERT, new[lit:i]))
+        ops.append((DELTA_OP_COPY, j, n))
+        shift = j - i
+        i += n
+        lit = i
+
+    if lit < len(new):
+        ops.append((DELTA_OP_INSERT, new[lit:]))
+    return ops
+
+
+def encode(ops, src_size, src_sha256, out_size):
+    out = bytearray(struct.pack(DELTA_HDR_FMT, DELTA_MAGIC, src_size, out_size, src_sha256))
+    for op in ops:
+        if op[0] == DELTA_OP_COPY:
+            out += struct.pack(DELTA_OP_FMT, DELTA_OP_COPY, op[2], op[1])
+        else:
+            out += struct.pack(DELTA_OP_FMT, DELTA_OP_INSERT, len(op[1]), 0)
+            out += op[1]
+    return bytes(out)
+
+
+def apply(patch, old):
+    """Reference implementation of the patcher in cpurad_boot/src/delta.c."""
+    magic, src_size, out_size, _ = struct.unpack_from(DELTA_HDR_FMT, patch)
+    if magic != DELTA_MAGIC:
+        raise ValueError("bad patch magic")
+    pos = struct.calcsize(DELTA_HDR_FMT)
+    out = bytearray()
+    while pos < len(patch):
+        op, length, src_off = struct.unpack_from(DELTA_OP_FMT, patch, pos)
+        pos += struct.calcsize(DELTA_OP_FMT)
+        if op == DELTA_OP_COPY:
+            if src_off + length > src_size:
+                raise ValueError("copy outside the source image")
+            out += old[src_off:src_off + length]
+        elif op == DELTA_OP_INSERT:
+            out += patch[pos:pos + length]
+            pos += length
+        else:
+            raise ValueError(f"bad op {op}")
+    if len(out) != out_size:
+        raise ValueError("patch output size mismatch")
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("old", help="zephyr.rad.bin of the image on the device")
+    parser.add_argument("new", help="zephyr.rad.bin of the image to install")
+    parser.add_argument("output", help="patch file")
+    args = parser.parse_args()
+
+    with open(args.old, "rb") as f:
+        old = f.read()
+    with open(args.new, "rb") as f:
+        new = f.read()
+
+    src_size, src_sha256 = image_info(old, args.old)
+    out_size, _ = image_info(new, args.new)
+    old = old[:src_size]
+    new = new[:out_size]
+
+    ops = diff(old, new)
+    patch = encode(ops, src_size, src_sha256, out_size)
+    if apply(patch, old) != new:
+        sys.exit("internal error: patch does not rebuild the new image")
+
+    with open(args.output, "wb") as f:
+        f.write(patch)
+
+    copies = sum(1 for op in ops if op[0] == DELTA_OP_COPY)
+    literal = sum(len(op[1]) for op in ops if op[0] == DELTA_OP_INSERT)
+    print(f"{args.output}: {len(patch)} bytes for a {len(new)} byte image "
+          f"({100 * len(patch) / len(new):.1f}%), {copies} copies, {literal} literal bytes")
+    print(f"image SHA-256 {hashlib.sha256(new).hexdigest()}")
+
+
+if __name__ == "__main__":
+    main()
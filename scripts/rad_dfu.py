@@ -0,0 +1,401 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+#
+"""Send an image to cpurad_boot over its vendor bulk DFU interface.
+
+The packets follow cpurad_boot/include/dfu_proto.h. DATA packets are
+pipelined: up to the window reported in the BEGIN response are kept in
+flight and every response frees one slot, so the device writes one chunk
+to MRAM while the next ones are on the bus.
+
+The BEGIN response carries the address the image has to be linked for.
+With A/B execute in place, pass the builds for both slots and the one
+matching the inactive slot is sent. An interrupted raw transfer is picked
+up again: the tool asks for the chunk bitmap and sends only what is
+missing.
+
+--hid sends the same packets in HID reports instead, for hosts that
+cannot bind a driver to the bulk interface. Reports are written back to
+back and the device holds them off while its buffers are busy; the status
+feature report is read after every command and once after the data.
+
+--bench prints throughput, per-chunk latency percentiles (DATA sent to
+its response; with --hid, per report written) and retries,
+e.g. to size flashing stations against the 748KB cpurad_app2_partition.
+
+Needs pyusb, or hidapi for --hid. Devices attached through USB/IP show up
+like local ones.
+"""
+
+import argparse
+import hashlib
+import os
+import struct
+import sys
+import time
+
+from rad_image import HEADER_FMT, IMAGE_MAGIC
+
+DFU_USB_CLASS = 0xFF
+DFU_USB_SUBCLASS = 0x44
+DFU_USB_PROTOCOL = 0x01
+
+DFU_CMD_BEGIN = 1
+DFU_CMD_DATA = 2
+DFU_CMD_END = 3
+DFU_CMD_ABORT = 4
+DFU_CMD_QUERY = 5
+
+DFU_FLAG_DELTA = 1 << 0
+DFU_FLAG_LZ4 = 1 << 1
+
+PKT_HDR_FMT = "<BBHI"
+PKT_RSP_FMT = "<BBBxI"
+PKT_HDR_SIZE = struct.calcsize(PKT_HDR_FMT)
+PKT_RSP_SIZE = struct.calcsize(PKT_RSP_FMT)
+
+# DFU over HID, see dfu_proto.h
+DFU_HID_DATA_REPORT_ID = 3
+DFU_HID_STATUS_REPORT_ID = 4
+DFU_HID_DATA_SIZE = 1023
+# dfu_pkt_rsp, written, data_status, reserved, map_len, map
+HID_STATUS_FMT = PKT_RSP_FMT + "IBxH240s"
+HID_STATUS_SIZE = struct.calcsize(HID_STATUS_FMT)
+
+# CONFIG_SAMPLE_USBD_VID / CONFIG_SAMPLE_USBD_PID of cpurad_boot
+BOOT_VID = 0x2FE3
+BOOT_PID = 0x0007
+
+# Long enough for the END response, which waits for the last writes
+RSP_TIMEOUT_MS = 5000
+
+
+# Response status values are Zephyr (newlib numbering) errno values, not
+# necessarily the ones of the host
+DFU_STATUS = {
+    5: "EIO",
+    8: "ENOEXEC",
+    16: "EBUSY",
+    22: "EINVAL",
+    27: "EFBIG",
+    61: "ENODATA",
+    77: "EBADMSG",
+    105: "ENOBUFS",
+    116: "ETIMEDOUT",
+    122: "EMSGSIZE",
+    133: "ESTALE",
+    134: "ENOTSUP",
+}
+DFU_STATUS_ENOBUFS = 105
+
+
+class DfuError(Exception):
+    pass
+
+
+def status_str(status):
+    return DFU_STATUS.get(status, f"errno {status}")
+
+
+class DfuDevice:
+    def __init__(self, vid=None, pid=None):
+        import usb.core
+        import usb.util
+
+        def match(dev):
+            if vid is not None and dev.idVendor != vid:
+                return False
+            if pid is not None and dev.idProduct != pid:
+                return False
+            return self._find_intf(dev) is not None
+
+        self.dev = usb.core.find(custom_match=match)
+        if self.dev is None:
+            raise DfuError("no device with a cpurad_boot DFU interface found")
+
+        intf = self._find_intf(self.dev)
+        if self.dev.is_kernel_driver_active(intf.bInterfaceNumber):
+            self.dev.detach_kernel_driver(intf.bInterfaceNumber)
+        usb.util.claim_interface(self.dev, intf.bInterfaceNumber)
+
+        direction = usb.util.endpoint_direction
+        self.ep_out = usb.util.find_descriptor(
+            intf, custom_match=lambda e: direction(e.bEndpointAddress) == usb.util.ENDPOINT_OUT)
+        self.ep_in = usb.util.find_descriptor(
+            intf, custom_match=lambda e: direction(e.bEndpointAddress) == usb.util.ENDPOINT_IN)
+
+    @staticmethod
+    def _find_intf(dev):
+        for cfg in dev:
+            for intf in cfg:
+                if (intf.bInterfaceClass, intf.bInterfaceSubClass,
+                        intf.bInterfaceProtocol) == (DFU_USB_CLASS, DFU_USB_SUBCLASS,
+                                                     DFU_USB_PROTOCOL):
+                    return intf
+        return None
+
+    def send(self, cmd, offset=0, payload=b"", flags=0):
+        pkt = struct.pack(PKT_HDR_FMT, cmd, flags, len(payload), offset) + payload
+        self.ep_out.write(pkt)
+        # The device queues OUT buffers larger than one packet, a transfer
+        # that fills its last packet must be ended by a zero length packet
+        if len(pkt) % self.ep_out.wMaxPacketSize == 0:
+            self.ep_out.write(b"")
+
+    def recv(self):
+        data = bytes(self.ep_in.read(512, timeout=RSP_TIMEOUT_MS))
+        if len(data) < PKT_RSP_SIZE:
+            raise DfuError(f"short response ({len(data)} bytes)")
+        cmd, status, window, offset = struct.unpack_from(PKT_RSP_FMT, data)
+        return cmd, status, window, offset, data[PKT_RSP_SIZE:]
+
+    def command(self, cmd, offset=0, payload=b"", flags=0):
+        self.send(cmd, offset, payload, flags)
+        rsp = self.recv()
+        if rsp[0] != cmd:
+            raise DfuError(f"response to cmd {rsp[0]} while waiting for cmd {cmd}")
+        return rsp
+
+
+class HidDfuDevice:
+    def __init__(self, vid=None, pid=None):
+        import hid
+
+        vid = BOOT_VID if vid is None else vid
+        pid = BOOT_PID if pid is None else pid
+        entries = hid.enumerate(vid, pid)
+        if not entries:
+            raise DfuError(f"no HID device {vid:04x}:{pid:04x} found")
+        # Where the OS splits top level collections, open the vendor one
+        entry = next((e for e in entries if e.get("usage_page") == 0xFF00), entries[0])
+
+        self.dev = hid.device()
+        self.dev.open_path(entry["path"])
+
+    def send(self, cmd, offset=0, payload=b"", flags=0):
+        pkt = struct.pack(PKT_HDR_FMT, cmd, flags, len(payload), offset) + payload
+        report = bytes([DFU_HID_DATA_REPORT_ID]) + pkt.ljust(DFU_HID_DATA_SIZE, b"\0")
+        if self.dev.write(report) < 0:
+            raise DfuError("HID output report not sent")
+
+    def status(self):
+        data = bytes(self.dev.get_feature_report(DFU_HID_STATUS_REPORT_ID,
+                                                 1 + HID_STATUS_SIZE))
+        if len(data) < 1 + HID_STATUS_SIZE:
+            raise DfuError(f"short status report ({len(data)} bytes)")
+        return struct.unpack_from(HID_STATUS_FMT, data, 1)
+
+    def command(self, cmd, offset=0, payload=b"", flags=0):
+        self.send(cmd, offset, payload, flags)
+        rsp_cmd, status, window, offset, _, _, map_len, bitmap = self.status()
+        if rsp_cmd != cmd:
+            raise DfuError(f"status of cmd {rsp_cmd} while waiting for cmd {cmd}")
+        return rsp_cmd, status, window, offset, bitmap[:map_len]
+
+
+def image_load_addr(data, name):
+    hdr_len = struct.calcsize(HEADER_FMT)
+    if len(data) < hdr_len:
+        sys.exit(f"{name}: too short for an image header")
+    magic, _, _, _, load_addr, *_ = struct.unpack_from(HEADER_FMT, data)
+    if magic != IMAGE_MAGIC:
+        sys.exit(f"{name}: no image header, use the zephyr.rad.bin from rad_image.py")
+    return load_addr
+
+
+def encode(image, args):
+    """Return (BEGIN flags, bytes sent as DATA) for the selected transport."""
+    if args.delta:
+        import rad_delta
+
+        with open(args.delta, "rb") as f:
+            old = f.read()
+        src_size, src_sha256 = rad_delta.image_info(old, args.delta)
+        patch = rad_delta.encode(rad_delta.diff(old[:src_size], image), src_size,
+                                 src_sha256, len(image))
+        return DFU_FLAG_DELTA, patch
+    if args.lz4:
+        import rad_lz4
+
+        block = rad_lz4.compress(image)
+        return DFU_FLAG_LZ4, struct.pack(rad_lz4.UNLZ4_HDR_FMT, rad_lz4.UNLZ4_MAGIC,
+                                         len(image)) + block
+    return 0, image
+
+
+def percentile(values, pct):
+    if not values:
+        return 0.0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * pct / 100))]
+
+
+class Transfer:
+    def __init__(self, dev, payload, chunk_size, retries):
+        self.dev = dev
+        self.payload = payload
+        self.chunk_size = chunk_size
+        self.retries = retries
+        self.retried = 0
+        self.latency = []
+        self.sent_bytes = 0
+
+    def chunks(self, bitmap=None):
+        for index, off in enumerate(range(0, len(self.payload), self.chunk_size)):
+            if bitmap is not None and index // 8 < len(bitmap) and \
+                    bitmap[index // 8] & (1 << (index % 8)):
+                continue
+            yield off
+
+    def run(self, window, bitmap=None):
+        pending = list(self.chunks(bitmap))
+        pending.reverse()
+        in_flight = {}
+        attempts = {}
+
+        while pending or in_flight:
+            while pending and len(in_flight) < window:
+                off = pending.pop()
+                data = self.payload[off:off + self.chunk_size]
+                in_flight[off] = time.perf_counter()
+                self.dev.send(DFU_CMD_DATA, off, data)
+                self.sent_bytes += len(data)
+
+            cmd, status, _, off, _ = self.dev.recv()
+            if cmd != DFU_CMD_DATA or off not in in_flight:
+                raise DfuError(f"unexpected response cmd {cmd} offset 0x{off:x}")
+            self.latency.append(time.perf_counter() - in_flight.pop(off))
+
+            if status == 0:
+                continue
+            # Only a full pool is worth retrying, anything else ends the session
+            attempts[off] = attempts.get(off, 0) + 1
+            if status != DFU_STATUS_ENOBUFS or attempts[off] > self.retries:
+                raise DfuError(f"DATA at 0x{off:x} failed, {status_str(status)}")
+            self.retried += 1
+            pending.append(off)
+
+
+    def run_hid(self, bitmap=None):
+        """Write the missing chunks as HID reports, the device applies backpressure."""
+        step = DFU_HID_DATA_SIZE - PKT_HDR_SIZE
+        runs = []
+        for off in self.chunks(bitmap):
+            end = min(off + self.chunk_size, len(self.payload))
+            if runs and runs[-1][1] == off:
+                runs[-1][1] = end
+            else:
+                runs.append([off, end])
+
+        # Reports may span chunks, only a skipped chunk starts a new run
+        for off, end in runs:
+            for pos in range(off, end, step):
+                start = time.perf_counter()
+                self.dev.send(DFU_CMD_DATA, pos, self.payload[pos:min(pos + step, end)])
+                self.latency.append(time.perf_counter() - start)
+            self.sent_bytes += end - off
+
+        *_, written, data_status, _, _ = self.dev.status()
+        if data_status != 0:
+            raise DfuError(f"DATA failed after {written} bytes, {status_str(data_status)}")
+
+
+def begin(dev, images, encode_fn):
+    """BEGIN with the image linked for the slot the device offers."""
+    candidates = list(images)
+    while candidates:
+        name, image = candidates.pop(0)
+        flags, payload = encode_fn(image)
+        _, status, window, load_addr, _ = dev.command(
+            DFU_CMD_BEGIN, len(payload), hashlib.sha256(image).digest(), flags)
+        if status != 0:
+            raise DfuError(f"BEGIN failed, {status_str(status)}")
+        if image_load_addr(image, name) == load_addr:
+            return name, image, payload, window
+
+        dev.command(DFU_CMD_ABORT)
+        candidates = [(n, img) for n, img in candidates if image_load_addr(img, n) == load_addr]
+        if not candidates:
+            raise DfuError(f"device wants an image linked for 0x{load_addr:08x}, "
+                           f"none of the given images is")
+    raise DfuError("no image to send")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("image", nargs="+",
+                        help="zephyr.rad.bin, one per slot with A/B execute in place")
+    parser.add_argument("--vid", type=lambda v: int(v, 0))
+    parser.add_argument("--pid", type=lambda v: int(v, 0))
+    parser.add_argument("--chunk-size", type=int, default=1024,
+                        help="CONFIG_RAD_BOOT_DFU_CHUNK_SIZE of the device (default 1024)")
+    parser.add_argument("--retries", type=int, default=3,
+                        help="resends of a chunk the device had no buffer for")
+    group = parser.add_mutually_exclusive_group()
+    group.add_argument("--delta", metavar="OLD",
+                       help="send a patch against OLD, the image in the other slot")
+    group.add_argument("--lz4", action="store_true", help="send the image LZ4 compressed")
+    parser.add_argument("--hid", action="store_true",
+                        help="use the HID interface instead of the bulk one")
+    parser.add_argument("--no-resume", action="store_true",
+                        help="send every chunk even if the device has some already")
+    parser.add_argument("--bench", action="store_true",
+                        help="print throughput, latency percentiles and retries")
+    args = parser.parse_args()
+
+    images = []
+    for path in args.image:
+        with open(path, "rb") as f:
+            data = f.read()
+        image_load_addr(data, path)
+        images.append((path, data))
+
+    try:
+        dev = HidDfuDevice(args.vid, args.pid) if args.hid else DfuDevice(args.vid, args.pid)
+        start = time.perf_counter()
+        name, image, payload, window = begin(dev, images, lambda img: encode(img, args))
+
+        chunk_size = args.chunk_size
+        bitmap = None
+        if not args.no_resume and not args.delta and not args.lz4:
+            _, status, _, dev_chunk, data = dev.command(DFU_CMD_QUERY)
+            if status == 0:
+                chunk_size, bitmap = dev_chunk, data
+
+        xfer = Transfer(dev, payload, chunk_size, args.retries)
+        if args.hid:
+            xfer.run_hid(bitmap)
+        else:
+            xfer.run(window, bitmap)
+        data_end = time.perf_counter()
+
+        _, status, _, _, _ = dev.command(DFU_CMD_END)
+        if status != 0:
+            raise DfuError(f"END failed, {status_str(status)}")
+        end = time.perf_counter()
+    except DfuError as e:
+        sys.exit(f"DFU failed: {e}")
+
+    skipped = len(payload) - xfer.sent_bytes
+    print(f"{os.path.basename(name)}: {len(image)} byte image, {len(payload)} bytes "
+          f"to send, {skipped} already on the device, done in {end - start:.3f} s")
+
+    if args.bench:
+        data_s = data_end - start
+        ms = [v * 1000 for v in xfer.latency]
+        unit = "report" if args.hid else "chunk"
+        print(f"window {window}, chunk {chunk_size} bytes, {len(ms)} {unit}s")
+        print(f"throughput {xfer.sent_bytes / 1024 / data_s if data_s else 0:.1f} KB/s "
+              f"(data), {xfer.sent_bytes / 1024 / (end - start):.1f} KB/s (incl. END "
+              f"{(end - data_end) * 1000:.1f} ms)")
+        print(f"{unit} latency ms: p50 {percentile(ms, 50):.2f} p90 {percentile(ms, 90):.2f} "
+              f"p99 {percentile(ms, 99):.2f} max {max(ms, default=0):.2f}")
+        print(f"retries {xfer.retried}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+#
+"""Put a cpurad_boot image header in front of an application image.
+
+The application must be linked with CONFIG_ROM_START_OFFSET equal to the
+header size, so the first --header-size bytes of its hex file are free.
+The header layout follows struct image_header in
+cpurad_boot/include/image.h.
+
+With --key the header is signed with ECDSA P-256 over SHA-256 and the raw
+r || s signature is placed right after it. --export-pubkey writes the
+uncompressed public point cpurad_boot is built with
+(CONFIG_RAD_BOOT_SIGNATURE_KEY).
+"""
+
+import argparse
+import hashlib
+import re
+import struct
+import sys
+
+IMAGE_MAGIC = 0x49444152
+HEADER_FMT = "<IHHIIBBHI32s"
+IMAGE_F_SIGNED = 0x0001
+IMAGE_SIG_SIZE = 64
+
+
+def load_key(path):
+    """Private key from a PEM file, or its public key if that is all there is."""
+    from cryptography.hazmat.primitives import serialization
+    from cryptography.hazmat.primitives.asymmetric import ec
+
+    with open(path, "rb") as f:
+        pem = f.read()
+    try:
+        key = serialization.load_pem_private_key(pem, password=None)
+    except ValueError:
+        key = serialization.load_pem_public_key(pem)
+    if not isinstance(key, (ec.EllipticCurvePrivateKey, ec.EllipticCurvePublicKey)) or \
+            key.curve.name != "secp256r1":
+        sys.exit(f"{path}: not a P-256 key")
+    return key
+
+
+def public_point(key):
+    from cryptography.hazmat.primitives import serialization
+    from cryptography.hazmat.primitives.asymmetric import ec
+
+    if isinstance(key, ec.EllipticCurvePrivateKey):
+        key = key.public_key()
+    return key.public_bytes(serialization.Encoding.X962,
+                            serialization.PublicFormat.UncompressedPoint)
+
+
+def sign_header(header, key):
+    from cryptography.hazmat.primitives import hashes
+    from cryptography.hazmat.primitives.asymmetric import ec
+    from cryptography.hazmat.primitives.asymmetric.utils import decode_dss_signature
+
+    if not isinstance(key, ec.EllipticCurvePrivateKey):
+        sys.exit("signing needs the private key")
+    r, s = decode_dss_signature(key.sign(header, ec.ECDSA(hashes.SHA256())))
+    return r.to_bytes(32, "big") + s.to_bytes(32, "big")
+
+
+def parse_version(text):
+    m = re.fullmatch(r"(\d+)\.(\d+)\.(\d+)(?:\+(\d+))?", text)
+    if not m:
+        raise argparse.ArgumentTypeError(f"bad version '{text}', expected X.Y.Z[+B]")
+    return tuple(int(v or 0) for v in m.groups())
+
+
+def read_hex(path):
+    """Return (base address, bytearray) of a contiguous Intel HEX image."""
+    data = {}
+    upper = 0
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith(":"):
+                continue
+            rec = bytes.fromhex(line[1:])
+            count, addr, rtype = rec[0], (rec[1] << 8) | rec[2], rec[3]
+            payload = rec[4:4 + count]
+            if rtype == 0x00:
+                base = upper + addr
+                for i, b in enumerate(payload):
+                    data[base + i] = b
+            elif rtype == 0x02:
+                upper = int.from_bytes(payload, "big") << 4
+            elif rtype == 0x04:
+                upper = int.from_bytes(payload, "big") << 16
+            elif rtype == 0x01:
+                break
+    if not data:
+        sys.exit(f"{path}: no data")
+    start, end = min(data), max(data) + 1
+    image = bytearray(b"\xff" * (end - start))
+    for addr, b in data.items():
+        image[addr - start] = b
+    return start, image
+
+
+def write_hex(path, base, image):
+    def record(rtype, addr, payload):
+        rec = bytes([len(payload), (addr >> 8) & 0xFF, addr & 0xFF, rtype]) + payload
+        return ":" + (rec + bytes([(-sum(rec)) & 0xFF])).hex().upper() + "\n"
+
+    with open(path, "w") as f:
+        upper = None
+        for off in range(0, len(image), 16):
+            addr = base + off
+            if addr >> 16 != upper:
+                upper = addr >> 16
+                f.write(record(0x04, 0, upper.to_bytes(2, "big")))
+            f.write(record(0x00, addr & 0xFFFF, bytes(image[off:off + 16])))
+        f.write(record(0x01, 0, b""))
+
+
+def build_header(body, header_size, load_addr, version, flags=0):
+    major, minor, revision, build = version
+    return struct.pack(HEADER_FMT, IMAGE_MAGIC, header_size, flags, len(body), load_addr,
+                       major, minor, revision, build, hashlib.sha256(body).digest())
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", nargs="?", help="application zephyr.hex")
+    parser.add_argument("output", nargs="?", help="hex file with the image header")
+    parser.add_argument("--bin", help="also write the slot contents as binary (DFU payload)")
+    parser.add_argument("--header-size", type=lambda v: int(v, 0), default=0x200)
+    parser.add_argument("--version", type=parse_version, default=(0, 0, 0, 0))
+    parser.add_argument("--key", help="PEM P-256 key to sign the header with")
+    parser.add_argument("--export-pubkey", metavar="FILE",
+                        help="write the 65 byte public point of --key to FILE and exit")
+    args = parser.parse_args()
+
+    key = load_key(args.key) if args.key else None
+    if args.export_pubkey:
+        if key is None:
+            parser.error("--export-pubkey needs --key")
+        with open(args.export_pubkey, "wb") as f:
+            f.write(public_point(key))
+        return
+    if args.input is None or args.output is None:
+        parser.error("input and output are required")
+
+    base, image = read_hex(args.input)
+    if len(image) <= args.header_size:
+        sys.exit("image is not larger than its header")
+    if any(b not in (0x00, 0xFF) for b in image[:args.header_size]):
+        sys.exit("header area is not empty, is CONFIG_ROM_START_OFFSET set?")
+
+    body = bytes(image[args.header_size:])
+    if key is None:
+        header = build_header(body, args.header_size, base, args.version)
+    else:
+        header = build_header(body, args.header_size, base, args.version, IMAGE_F_SIGNED)
+        header += sign_header(header, key)
+    if len(header) > args.header_size:
+        sys.exit("header does not fit in --header-size")
+    image[:args.header_size] = header + b"\xff" * (args.header_size - len(header))
+
+    write_hex(args.output, base, image)
+    if args.bin:
+        with open(args.bin, "wb") as f:
+            f.write(image)
+
+    print(f"{args.output}: {len(body)} bytes at 0x{base + args.header_size:08x}, "
+          f"version {'.'.join(map(str, args.version[:3]))}+{args.version[3]}"
+          f"{', signed' if key else ''}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2025 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+#
+"""Compress a zephyr.rad.bin for the cpurad_boot LZ4 DFU transport.
+
+The output is the header from cpurad_boot/include/unlz4.h followed by one
+LZ4 block (lz4_Block_format.md). The block is decoded again before it is
+written, so a stream that does not rebuild the input is never produced.
+"""
+
+import argparse
+import struct
+import sys
+
+UNLZ4_MAGIC = 0x345A4C52
+UNLZ4_HDR_FMT = "<II"
+
+MIN_MATCH = 4
+# Block format end conditions: the last match starts at least MFLIMIT bytes
+# before the end and the last LAST_LITERALS bytes are always literals
+MFLIMIT = 12
+LAST_LITERALS = 5
+MAX_OFFSET = 0xFFFF
+
+
+def write_len(out, value):
+    while value >= 255:
+        out.append(255)
+        value -= 255
+    out.append(value)
+
+
+def sequence(out, literals, offset=None, match_len=0):
+    lit_len = len(literals)
+    ml = match_len - MIN_MATCH if offset is not None else 0
+    out.append((min(lit_len, 15) << 4) | min(ml, 15))
+    if lit_len >= 15:
+        write_len(out, lit_len - 15)
+    out += literals
+    if offset is not None:
+        out += struct.pack("<H", offset)
+        if ml >= 15:
+            write_len(out, ml - 15)
+
+
+def match_len(src, cand, i, limit):
+    n = 0
+    step = 256
+    while i + n + step <= limit and src[cand + n:cand + n + step] == src[i + n:i + n + step]:
+        n += step
+    while i + n < limit and src[cand + n] == src[i + n]:
+        n += 1
+    return n
+
+
+def compress(src):
+    out = bytearray()
+    table = {}
+    anchor = 0
+    i = 0
+    while i < len(src) - MFLIMIT:
+        key = src[i:i + MIN_MATCH]
+        cand = table.get(key)
+        table[key] = i
+        if cand is None or i - cand > MAX_OFFSET:
+            i += 1
+            continue
+
+        while i > anchor and cand > 0 and src[i - 1] == src[cand - 1]:
+            i -= 1
+            cand -= 1
+
+        n = match_len(src, cand, i, len(src) - LAST_LITERALS)
+        sequence(out, src[anchor:i], i - cand, n)
+        for pos in range(i + 1, min(i + n, len(src) - MFLIMIT)):
+            table[src[pos:pos + MIN_MATCH]] = pos
+        i += n
+        anchor = i
+
+    sequence(out, src[anchor:])
+    return bytes(out)
+
+
+def read_len(data, pos):
+    total = 0
+    while True:
+        b = data[pos]
+        pos += 1
+        total += b
+        if b != 255:
+            return total, pos
+
+
+def decompress(block, out_size):
+    """Reference implementation of the decoder in cpurad_boot/src/unlz4.c."""
+    out = bytearray()
+    pos = 0
+    while True:
+        token = block[pos]
+        pos += 1
+        lit_len = token >> 4
+        if lit_len == 15:
+            extra, pos = read_len(block, pos)
+            lit_len += extra
+        out += block[pos:pos + lit_len]
+        pos += lit_len
+        if len(out) == out_size:
+            break
+        offset = block[pos] | (block[pos + 1] << 8)
+        pos += 2
+        ml = token & 0xF
+        if ml == 15:
+            extra, pos = read_len(block, pos)
+            ml += extra
+        ml += MIN_MATCH
+        if offset == 0 or offset > len(out):
+            raise ValueError("bad match offset")
+        for _ in range(ml):
+            out.append(out[-offset])
+    if pos != len(block):
+        raise ValueError("trailing data after the last sequence")
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", help="zephyr.rad.bin")
+    parser.add_argument("output", help="compressed stream")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as f:
+        data = f.read()
+    if not data:
+        sys.exit(f"{args.input}: empty")
+
+    block = compress(data)
+    if decompress(block, len(data)) != data:
+        sys.exit("internal error: block does not decode to the input")
+
+    stream = struct.pack(UNLZ4_HDR_FMT, UNLZ4_MAGIC, len(data)) + block
+    with open(args.output, "wb") as f:
+        f.write(stream)
+
+    print(f"{args.output}: {len(stream)} bytes for a {len(data)} byte image "
+          f"({100 * len(stream) / len(data):.1f}%)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/flash/flash_simulator.h>
+#include <zephyr/storage/flash_map.h>
+#include <psa/crypto.h>
+#include <boot_timeline.h>
+#include <image.h>
+#include <timeline.h>
+
+#define HDR_SIZE                0x200
+/* SystemCoreClock of the radio core */
+#define CYCLES_PER_SEC          256000000U
+#define WRAP_CYCLES             BIT64(32)
+
+static struct boot_timeline tl;
+static const struct flash_area *slot_fa;
+
+/* The line hid_mouse logs, scripts/boot_timeline.py --log reads it */
+static void timeline_print(const char *what)
+{
+	char line[BOOT_TIMELINE_MAX * 14 + 1];
+	int pos = 0;
+
+	for (int i = 0; i < tl.count; i++) {
+		pos += snprintk(&line[pos], sizeof(line) - pos, "%s%u:%u",
+				i ? "," : "", tl.stage[i], tl.stamp[i]);
+	}
+
+	TC_PRINT("%s: boot_tl v%u %s\n", what, tl.version, line);
+}
+
+static bool timeline_has(enum boot_tl_stage stage)
+{
+	for (int i = 0; i < tl.count; i++) {
+		if (tl.stage[i] == stage) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static uint32_t timeline_stamp(enum boot_tl_stage stage)
+{
+	for (int i = 0; i < tl.count; i++) {
+		if (tl.stage[i] == stage) {
+			return tl.stamp[i];
+		}
+	}
+
+	zassert_unreachable("stage %d not marked", stage);
+	return 0;
+}
+
+/* A full slot: header, then the image up to the end of the partition */
+static void image_install(void)
+{
+	static uint8_t buf[1024] __aligned(4);
+	struct image_header *hdr = (struct image_header *)buf;
+	psa_hash_operation_t op = PSA_HASH_OPERATION_INIT;
+	size_t img_size = slot_fa->fa_size - HDR_SIZE;
+	size_t len;
+
+	zassert_ok(flash_area_flatten(slot_fa, 0, slot_fa->fa_size));
+	zassert_equal(psa_hash_setup(&op, PSA_ALG_SHA_256), PSA_SUCCESS);
+
+	for (size_t off = 0; off < img_size; off += sizeof(buf)) {
+		size_t n = MIN(sizeof(buf), img_size - off);
+
+		for (size_t i = 0; i < n; i++) {
+			buf[i] = (uint8_t)((off + i) * 7 + ((off + i) >> 9));
+		}
+		zassert_equal(psa_hash_update(&op, buf, n), PSA_SUCCESS);
+		zassert_ok(flash_area_write(slot_fa, HDR_SIZE + off, buf, n));
+	}
+
+	memset(buf, 0xFF, HDR_SIZE);
+	hdr->magic = IMAGE_MAGIC;
+	hdr->hdr_size = HDR_SIZE;
+	hdr->flags = 0;
+	hdr->img_size = img_size;
+	hdr->load_addr = image_load_addr(IMAGE_SLOT_PRIMARY);
+	hdr->version = (struct image_version) { .major = 1 };
+	zassert_equal(psa_hash_finish(&op, hdr->sha256, sizeof(hdr->sha256), &len),
+		      PSA_SUCCESS);
+	zassert_ok(flash_area_write(slot_fa, 0, buf, HDR_SIZE));
+}
+
+static void *boot_timeline_setup(void)
+{
+	const struct device *flash = DEVICE_DT_GET(DT_PARENT(DT_NODELABEL(flash0)));
+	size_t size;
+
+	image_test_map(flash_simulator_get_memory(flash, &size));
+	zassert_equal(psa_crypto_init(), PSA_SUCCESS);
+
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(cpurad_app_partition), &slot_fa));
+	image_install();
+
+	return NULL;
+}
+
+/*
+ * The stages cpurad_boot marks up to the jump when no DFU is needed, on
+ * the host clock. Between main and the decision sits the check of the
+ * primary slot; USB is never brought up. The register cleanup has no
+ * host counterpart, so the jump follows the decision directly.
+ */
+static uint32_t fast_boot(void)
+{
+	uint32_t start = timeline_now();
+
+	boot_timeline_reset(&tl, USEC_PER_SEC);
+	boot_timeline_append(&tl, BOOT_TL_EARLY_INIT, 0);
+	boot_timeline_append(&tl, BOOT_TL_MAIN, timeline_now() - start);
+	zassert_ok(image_validate(IMAGE_SLOT_PRIMARY));
+	boot_timeline_append(&tl, BOOT_TL_DECISION, timeline_now() - start);
+	boot_timeline_append(&tl, BOOT_TL_JUMP, timeline_now() - start);
+
+	zassert_false(timeline_has(BOOT_TL_USB_INIT));
+	zassert_false(timeline_has(BOOT_TL_DFU_DONE));
+
+	return timeline_stamp(BOOT_TL_DECISION) - timeline_stamp(BOOT_TL_MAIN);
+}
+
+ZTEST(boot_timeline, test_fast_path)
+{
+	uint32_t cold, warm;
+
+	image_cache_invalidate(IMAGE_SLOT_PRIMARY);
+	cold = fast_boot();
+	zassert_equal(image_verified_by(IMAGE_SLOT_PRIMARY), BOOT_VERIFY_DIGEST);
+	timeline_print("cold cache");
+
+	warm = fast_boot();
+	zassert_equal(image_verified_by(IMAGE_SLOT_PRIMARY), BOOT_VERIFY_CACHED);
+	timeline_print("warm cache");
+
+	TC_PRINT("%u KB image: boot decision %u us cold, %u us warm\n",
+		 (uint32_t)(slot_fa->fa_size / 1024), cold, warm);
+}
+
+/*
+ * A DFU session far longer than the 16.7 s wrap period of the cycle
+ * counter, synced every half period as the bootloader's timer does. The
+ * stages stay in marking order with stamps that keep growing.
+ */
+ZTEST(boot_timeline, test_counter_wrap)
+{
+	static const uint8_t expect[] = {
+		BOOT_TL_EARLY_INIT, BOOT_TL_MAIN, BOOT_TL_DECISION, BOOT_TL_USB_INIT,
+		BOOT_TL_DFU_DONE, BOOT_TL_USB_SHUTDOWN, BOOT_TL_JUMP,
+	};
+	uint64_t cycles = 1000;
+	uint64_t session_end;
+
+	boot_timeline_reset(&tl, CYCLES_PER_SEC);
+	boot_timeline_append(&tl, BOOT_TL_EARLY_INIT, (uint32_t)cycles);
+	cycles += CYCLES_PER_SEC / 1000;
+	boot_timeline_append(&tl, BOOT_TL_MAIN, (uint32_t)cycles);
+	cycles += CYCLES_PER_SEC / 1000;
+	boot_timeline_append(&tl, BOOT_TL_DECISION, (uint32_t)cycles);
+	cycles += CYCLES_PER_SEC / 100;
+	boot_timeline_append(&tl, BOOT_TL_USB_INIT, (uint32_t)cycles);
+
+	/* 40 s, more than two wraps */
+	session_end = cycles + 40ULL * CYCLES_PER_SEC;
+	while (cycles < session_end) {
+		cycles = MIN(cycles + WRAP_CYCLES / 2, session_end);
+		(void)boot_timeline_sync(&tl, (uint32_t)cycles);
+	}
+
+	boot_timeline_append(&tl, BOOT_TL_DFU_DONE, (uint32_t)cycles);
+	cycles += CYCLES_PER_SEC / 1000;
+	boot_timeline_append(&tl, BOOT_TL_USB_SHUTDOWN, (uint32_t)cycles);
+	cycles += CYCLES_PER_SEC / 10000;
+	boot_timeline_append(&tl, BOOT_TL_JUMP, (uint32_t)cycles);
+	timeline_print("40 s DFU session");
+
+	zassert_equal(tl.count, ARRAY_SIZE(expect));
+	zassert_mem_equal(tl.stage, expect, sizeof(expect));
+	for (int i = 1; i < tl.count; i++) {
+		zassert_true(tl.stamp[i] > tl.stamp[i - 1], "stage %u", tl.stage[i]);
+	}
+	zassert_equal(tl.wraps, cycles / WRAP_CYCLES);
+	zassert_equal(timeline_stamp(BOOT_TL_JUMP), cycles * USEC_PER_SEC / CYCLES_PER_SEC);
+}
+
+/* Marks past the end of the record are dropped, the first ones stay */
+ZTEST(boot_timeline, test_full)
+{
+	boot_timeline_reset(&tl, CYCLES_PER_SEC);
+
+	for (uint32_t i = 0; i < BOOT_TIMELINE_MAX + 4; i++) {
+		boot_timeline_append(&tl, i % BOOT_TL_STAGE_COUNT, i * (CYCLES_PER_SEC / 1000));
+	}
+
+	zassert_true(boot_timeline_is_valid(&tl));
+	zassert_equal(tl.count, BOOT_TIMELINE_MAX);
+	zassert_equal(tl.stamp[BOOT_TIMELINE_MAX - 1], (BOOT_TIMELINE_MAX - 1) * 1000);
+}
+
+ZTEST_SUITE(boot_timeline, NULL, boot_timeline_setup, NULL, NULL, NULL);
@@ -0,0 +1,26 @@
+#
+# Copyright (c) 2025 Nordic Semiconductor
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+#
+# Included by the cpurad_boot host test suites after find_package(Zephyr):
+# the timeline stub and the cpurad_boot and common include directories.
+
+set(RAD_BOOT_DIR ${CMAKE_CURRENT_LIST_DIR}/../../cpurad_boot)
+
+target_sources(app PRIVATE
+  ${CMAKE_CURRENT_LIST_DIR}/src/timeline_stub.c
+)
+target_include_directories(app PRIVATE
+  ${CMAKE_CURRENT_LIST_DIR}/include
+  ${RAD_BOOT_DIR}/include
+  ${CMAKE_CURRENT_LIST_DIR}/../../common/include
+)
+
+# Simulated time stands still while the code under test runs, the timeline
+# counts on the host clock
+if(CONFIG_NATIVE_LIBRARY)
+  target_sources(native_simulator INTERFACE
+    ${CMAKE_CURRENT_LIST_DIR}/src/host_time.c
+  )
+endif()
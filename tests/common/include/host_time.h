@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef H_HOST_TIME_
+#define H_HOST_TIME_
+
+#include <stdint.h>
+
+/**
+ * Monotonic host clock in microseconds. Simulated time stands still while
+ * test code runs, this one does not. Provided by src/host_time.c in the
+ * native simulator runner.
+ */
+uint64_t host_time_us(void);
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * cpurad_boot/src/timeline.c runs on the DWT and keeps its stamps in
+ * retained RAM. Host tests count host microseconds instead, one "cycle"
+ * per microsecond. Suites that check the calls made by the unit under
+ * test override the weak functions.
+ */
+
+#include <errno.h>
+#include <zephyr/kernel.h>
+#include <host_time.h>
+#include <timeline.h>
+
+uint32_t timeline_now(void)
+{
+	return (uint32_t)host_time_us();
+}
+
+uint32_t timeline_cyc_to_us(uint32_t cycles)
+{
+	return cycles;
+}
+
+uint32_t timeline_us_to_cyc(uint32_t us)
+{
+	return us;
+}
+
+__weak void timeline_mark(enum boot_tl_stage stage)
+{
+	ARG_UNUSED(stage);
+}
+
+__weak int timeline_poll(const volatile uint32_t *reg, uint32_t mask, uint32_t expect,
+			 uint32_t timeout_us, uint32_t *waited_us)
+{
+	uint32_t start = timeline_now();
+	uint32_t elapsed;
+	int err = -ETIMEDOUT;
+
+	do {
+		elapsed = timeline_now() - start;
+		if ((*reg & mask) == expect) {
+			err = 0;
+			break;
+		}
+	} while (elapsed < timeout_us);
+
+	*waited_us = elapsed;
+
+	return err;
+}
+
+__weak void timeline_delay_us(uint32_t us)
+{
+	uint32_t start = timeline_now();
+
+	while (timeline_now() - start < us) {
+	}
+}
+
+void timeline_log(void)
+{
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/flash/flash_simulator.h>
+#include <zephyr/storage/flash_map.h>
+#include <host_time.h>
+#include <dfu_engine.h>
+#include <image.h>
+
+#define CHUNK                   CONFIG_RAD_BOOT_DFU_CHUNK_SIZE
+#define WRITE_BLOCK             16
+
+static uint8_t readback[CHUNK];
+static const struct flash_area *slot_fa;
+
+/* Run the benchmark as cpurad_boot does at boot, return the host time */
+static uint32_t bench_run(struct dfu_engine_stats *stats)
+{
+	uint64_t start = host_time_us();
+	uint32_t us;
+
+	dfu_bench_run();
+	us = (uint32_t)(host_time_us() - start);
+	dfu_engine_stats_get(stats);
+
+	return us;
+}
+
+/* dfu_bench_run() fills chunk n with the low byte of n */
+static void slot_check(void)
+{
+	for (uint32_t off = 0; off < slot_fa->fa_size; off += CHUNK) {
+		size_t n = MIN(CHUNK, slot_fa->fa_size - off);
+
+		zassert_ok(flash_area_read(slot_fa, off, readback, n));
+		for (size_t i = 0; i < n; i++) {
+			zassert_equal(readback[i], (uint8_t)(off / CHUNK),
+				      "byte 0x%x", off + (uint32_t)i);
+		}
+	}
+}
+
+static void *dfu_bench_setup(void)
+{
+	const struct device *flash = DEVICE_DT_GET(DT_PARENT(DT_NODELABEL(flash0)));
+	size_t size;
+
+	image_test_map(flash_simulator_get_memory(flash, &size));
+	dfu_engine_init(NULL);
+
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(cpurad_app2_partition), &slot_fa));
+	zassert_equal(image_slot_size(dfu_engine_slot()), slot_fa->fa_size);
+
+	return NULL;
+}
+
+static void dfu_bench_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(flash_area_flatten(slot_fa, 0, slot_fa->fa_size));
+}
+
+ZTEST(dfu_bench, test_bench)
+{
+	struct dfu_engine_stats stats;
+	uint32_t us = bench_run(&stats);
+
+	zassert_equal(stats.bytes, slot_fa->fa_size);
+	zassert_equal(stats.chunks, DIV_ROUND_UP(slot_fa->fa_size, CHUNK));
+	/* Chunks whose pattern is the erased value are skipped */
+	zassert_equal(stats.blocks_written + stats.blocks_skipped,
+		      slot_fa->fa_size / WRITE_BLOCK);
+	slot_check();
+
+	TC_PRINT("%u KB through the engine in %u us on the host\n",
+		 (uint32_t)(slot_fa->fa_size / 1024), us);
+}
+
+/* The pattern is the same every run, so the second one programs nothing */
+ZTEST(dfu_bench, test_rerun)
+{
+	struct dfu_engine_stats stats;
+	uint32_t first, again;
+
+	first = bench_run(&stats);
+	again = bench_run(&stats);
+
+	zassert_equal(stats.bytes, slot_fa->fa_size);
+	zassert_equal(stats.blocks_written, 0);
+	zassert_equal(stats.blocks_skipped, slot_fa->fa_size / WRITE_BLOCK);
+	slot_check();
+
+	TC_PRINT("Blank slot %u us, unchanged slot %u us\n", first, again);
+}
+
+ZTEST_SUITE(dfu_bench, NULL, dfu_bench_setup, dfu_bench_before, NULL, NULL);
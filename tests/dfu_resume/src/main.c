@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/storage/flash_map.h>
+#include <dfu_engine.h>
+#include <dfu_state.h>
+#include <mram.h>
+
+#define CHUNK                   CONFIG_RAD_BOOT_DFU_CHUNK_SIZE
+/* Not a whole number of chunks, the last one is short */
+#define IMAGE_SIZE              (40 * CHUNK + 300)
+#define IMAGE_CHUNKS            DIV_ROUND_UP(IMAGE_SIZE, CHUNK)
+#define CUTS                    200
+
+static uint8_t image[IMAGE_SIZE];
+static uint8_t digest[DFU_DIGEST_SIZE];
+static uint8_t readback[CHUNK];
+static const struct flash_area *slot_fa;
+
+/* Fixed seed, so a failure can be replayed */
+static uint32_t rnd_state = 0x2545F491;
+
+static uint32_t rnd(void)
+{
+	rnd_state ^= rnd_state << 13;
+	rnd_state ^= rnd_state >> 17;
+	rnd_state ^= rnd_state << 5;
+
+	return rnd_state;
+}
+
+/* Lose everything but the partitions, like a reset does */
+static void power_cut(void)
+{
+	dfu_state_test_reset();
+}
+
+static bool chunk_done(uint32_t chunk)
+{
+	size_t len;
+	const uint8_t *map = dfu_state_bitmap(&len);
+
+	zassert_true(chunk / 8 < len);
+	return map[chunk / 8] & BIT(chunk % 8);
+}
+
+static size_t chunk_len(uint32_t chunk)
+{
+	return MIN(CHUNK, IMAGE_SIZE - chunk * CHUNK);
+}
+
+/* Where a power cut hits a chunk */
+enum cut_at {
+	CUT_NONE,
+	CUT_BEFORE_WRITE,
+	CUT_MID_WRITE,
+	CUT_BEFORE_MARK,
+};
+
+/*
+ * What the DFU engine does with a received chunk: write it to the slot,
+ * then mark it. @p cut stops the sequence part way.
+ */
+static void chunk_write(uint32_t chunk, enum cut_at cut)
+{
+	uint32_t off = chunk * CHUNK;
+
+	if (cut == CUT_BEFORE_WRITE) {
+		return;
+	}
+
+	if (cut == CUT_MID_WRITE) {
+		/* Some write units made it, the rest holds whatever was there */
+		zassert_ok(mram_write(slot_fa, off, &image[off],
+				      ROUND_DOWN(rnd() % chunk_len(chunk), 16)));
+		return;
+	}
+
+	zassert_ok(mram_write(slot_fa, off, &image[off], chunk_len(chunk)));
+
+	if (cut == CUT_BEFORE_MARK) {
+		return;
+	}
+
+	dfu_state_mark(off);
+}
+
+static void dfu_resume_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	for (size_t i = 0; i < sizeof(image); i++) {
+		image[i] = rnd();
+	}
+	for (size_t i = 0; i < sizeof(digest); i++) {
+		digest[i] = rnd();
+	}
+
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(cpurad_app2_partition), &slot_fa));
+	zassert_ok(flash_area_flatten(slot_fa, 0, slot_fa->fa_size));
+	dfu_state_clear();
+	power_cut();
+}
+
+ZTEST(dfu_resume, test_new_session)
+{
+	zassert_false(dfu_state_begin(IMAGE_SLOT_SECONDARY, IMAGE_SIZE, digest));
+	zassert_equal(dfu_state_missing(), IMAGE_CHUNKS);
+
+	chunk_write(0, CUT_NONE);
+	chunk_write(7, CUT_NONE);
+	power_cut();
+
+	/* Same image: resumed with its bits */
+	zassert_true(dfu_state_begin(IMAGE_SLOT_SECONDARY, IMAGE_SIZE, digest));
+	zassert_equal(dfu_state_missing(), IMAGE_CHUNKS - 2);
+	zassert_true(chunk_done(0));
+	zassert_true(chunk_done(7));
+	zassert_false(chunk_done(1));
+
+	/* Another image, size or slot starts over */
+	digest[0] ^= 1;
+	zassert_false(dfu_state_begin(IMAGE_SLOT_SECONDARY, IMAGE_SIZE, digest));
+	zassert_equal(dfu_state_missing(), IMAGE_CHUNKS);
+	zassert_false(dfu_state_begin(IMAGE_SLOT_SECONDARY, IMAGE_SIZE - 1, digest));
+	zassert_false(dfu_state_begin(IMAGE_SLOT_PRIMARY, IMAGE_SIZE - 1, digest));
+
+	/* And a finished session is gone */
+	dfu_state_clear();
+	power_cut();
+	zassert_false(dfu_state_begin(IMAGE_SLOT_PRIMARY, IMAGE_SIZE - 1, digest));
+}
+
+/*
+ * Send the image in random order and cut the power at random points. Each
+ * session must resume with exactly the chunks that were marked, cost at
+ * most the chunk in flight, and end with the image intact in the slot.
+ */
+ZTEST(dfu_resume, test_power_cut)
+{
+	uint32_t order[IMAGE_CHUNKS];
+	uint32_t sent = 0, sessions = 0, marked = 0;
+
+	for (uint32_t i = 0; i < IMAGE_CHUNKS; i++) {
+		order[i] = i;
+	}
+	for (uint32_t i = IMAGE_CHUNKS - 1; i > 0; i--) {
+		uint32_t j = rnd() % (i + 1);
+		uint32_t t = order[i];
+
+		order[i] = order[j];
+		order[j] = t;
+	}
+
+	for (uint32_t cuts = 0; ; cuts++) {
+		bool resumed = dfu_state_begin(IMAGE_SLOT_SECONDARY, IMAGE_SIZE, digest);
+		uint32_t missing = dfu_state_missing();
+		/* Cut somewhere in this session, or let the last one finish */
+		uint32_t cut_after = cuts < CUTS ? rnd() % (missing + 1) : UINT32_MAX;
+		uint32_t n = 0;
+
+		sessions++;
+		zassert_equal(resumed, sessions > 1);
+		zassert_equal(missing, IMAGE_CHUNKS - marked,
+			      "session %u: %u missing, %u marked", sessions, missing, marked);
+
+		if (missing == 0) {
+			break;
+		}
+
+		/* The host sends what the bitmap lacks */
+		for (uint32_t i = 0; i < IMAGE_CHUNKS; i++) {
+			uint32_t chunk = order[i];
+
+			if (chunk_done(chunk)) {
+				continue;
+			}
+
+			if (n++ == cut_after) {
+				chunk_write(chunk, (enum cut_at)(CUT_BEFORE_WRITE + rnd() % 3));
+				sent++;
+				break;
+			}
+
+			chunk_write(chunk, CUT_NONE);
+			sent++;
+			marked++;
+		}
+
+		power_cut();
+	}
+
+	/* Whatever was cut, the slot holds the image */
+	for (uint32_t chunk = 0; chunk < IMAGE_CHUNKS; chunk++) {
+		zassert_ok(flash_area_read(slot_fa, chunk * CHUNK, readback, chunk_len(chunk)));
+		zassert_mem_equal(readback, &image[chunk * CHUNK], chunk_len(chunk),
+				  "chunk %u", chunk);
+	}
+
+	/* Only the chunk in flight at each cut was sent twice */
+	zassert_true(sent <= IMAGE_CHUNKS + sessions - 1, "%u chunks sent", sent);
+
+	TC_PRINT("%u chunks, %u sessions, %u chunks sent\n", IMAGE_CHUNKS, sessions, sent);
+}
+
+ZTEST_SUITE(dfu_resume, NULL, NULL, dfu_resume_before, NULL, NULL);
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/flash/flash_simulator.h>
+#include <psa/crypto.h>
+#include <host_time.h>
+#include <image.h>
+
+#define HDR_SIZE                0x200
+/* Header and image fill most of the 64KB slot */
+#define IMAGE_SIZE              (60 * 1024)
+#define LATENCY_RUNS            20
+
+/* Private scalar of the key in src/rad_pubkey.inc, for this test only */
+static const uint8_t test_key[] = {
+	0x18, 0xc1, 0x9f, 0x2d, 0x0e, 0x76, 0x6c, 0x42,
+	0xc2, 0xce, 0x7e, 0x0c, 0x4a, 0x8b, 0xa4, 0x11,
+	0x24, 0xfa, 0xe0, 0xdb, 0xd1, 0x07, 0x45, 0x04,
+	0xbd, 0x95, 0x0c, 0xc9, 0x37, 0x70, 0x6e, 0xc4,
+};
+
+/* The primary slot as rad_image.py --key fills it: header, signature,
+ * padding, image. It lives in the flash simulator memory, which image.c
+ * reads as memory mapped MRAM.
+ */
+static uint8_t *slot;
+static struct image_header *hdr;
+static uint8_t *sig;
+static psa_key_id_t sign_key;
+
+static psa_key_id_t key_add(const uint8_t *priv, size_t len)
+{
+	psa_key_attributes_t attr = PSA_KEY_ATTRIBUTES_INIT;
+	psa_key_id_t key;
+
+	psa_set_key_type(&attr, PSA_KEY_TYPE_ECC_KEY_PAIR(PSA_ECC_FAMILY_SECP_R1));
+	psa_set_key_bits(&attr, 256);
+	psa_set_key_usage_flags(&attr, PSA_KEY_USAGE_SIGN_MESSAGE);
+	psa_set_key_algorithm(&attr, PSA_ALG_ECDSA(PSA_ALG_SHA_256));
+
+	if (priv != NULL) {
+		zassert_equal(psa_import_key(&attr, priv, len, &key), PSA_SUCCESS);
+	} else {
+		zassert_equal(psa_generate_key(&attr, &key), PSA_SUCCESS);
+	}
+
+	return key;
+}
+
+static void digest_update(void)
+{
+	size_t len;
+
+	zassert_equal(psa_hash_compute(PSA_ALG_SHA_256, slot + hdr->hdr_size, hdr->img_size,
+				       hdr->sha256, sizeof(hdr->sha256), &len), PSA_SUCCESS);
+}
+
+static void header_sign(psa_key_id_t key)
+{
+	size_t len;
+
+	zassert_equal(psa_sign_message(key, PSA_ALG_ECDSA(PSA_ALG_SHA_256),
+				       (const uint8_t *)hdr, sizeof(*hdr),
+				       sig, IMAGE_SIG_SIZE, &len), PSA_SUCCESS);
+	zassert_equal(len, IMAGE_SIG_SIZE);
+}
+
+static void *image_verify_setup(void)
+{
+	const struct device *flash = DEVICE_DT_GET(DT_PARENT(DT_NODELABEL(flash0)));
+	size_t size;
+
+	image_test_map(flash_simulator_get_memory(flash, &size));
+	slot = (uint8_t *)(uintptr_t)image_slot_addr(IMAGE_SLOT_PRIMARY);
+	hdr = (struct image_header *)slot;
+	sig = slot + sizeof(struct image_header);
+
+	zassert_equal(psa_crypto_init(), PSA_SUCCESS);
+	sign_key = key_add(test_key, sizeof(test_key));
+
+	return NULL;
+}
+
+static void image_verify_before(void *fixture)
+{
+	struct image_header h = {
+		.magic = IMAGE_MAGIC,
+		.hdr_size = HDR_SIZE,
+		.flags = IMAGE_F_SIGNED,
+		.img_size = IMAGE_SIZE,
+		.load_addr = image_load_addr(IMAGE_SLOT_PRIMARY),
+		.version = { .major = 1, .minor = 2, .revision = 3, .build = 4 },
+	};
+
+	ARG_UNUSED(fixture);
+
+	for (size_t i = 0; i < IMAGE_SIZE; i++) {
+		slot[HDR_SIZE + i] = (uint8_t)(i * 7 + (i >> 8));
+	}
+
+	memset(slot, 0xFF, HDR_SIZE);
+	memcpy(hdr, &h, sizeof(h));
+	digest_update();
+	header_sign(sign_key);
+
+	/* As the bootloader does before it writes a slot */
+	image_cache_invalidate(IMAGE_SLOT_PRIMARY);
+}
+
+ZTEST(image_verify, test_signed)
+{
+	zassert_ok(image_validate(IMAGE_SLOT_PRIMARY));
+	zassert_equal(image_verified_by(IMAGE_SLOT_PRIMARY), BOOT_VERIFY_DIGEST);
+}
+
+ZTEST(image_verify, test_unsigned)
+{
+	/* What rad_image.py writes without --key */
+	hdr->flags &= ~IMAGE_F_SIGNED;
+	memset(sig, 0xFF, IMAGE_SIG_SIZE);
+	zassert_equal(image_validate(IMAGE_SLOT_PRIMARY), -EPERM);
+	zassert_equal(image_verified_by(IMAGE_SLOT_PRIMARY), BOOT_VERIFY_NONE);
+
+	/* A flag without room for the signature in front of the image */
+	hdr->flags |= IMAGE_F_SIGNED;
+	hdr->hdr_size = sizeof(*hdr) + IMAGE_SIG_SIZE - 1;
+	digest_update();
+	zassert_equal(image_validate(IMAGE_SLOT_PRIMARY), -EPERM);
+}
+
+ZTEST(image_verify, test_bad_signature)
+{
+	sig[IMAGE_SIG_SIZE / 2] ^= 0x01;
+	zassert_equal(image_validate(IMAGE_SLOT_PRIMARY), -EPERM);
+}
+
+ZTEST(image_verify, test_header_changed)
+{
+	/* The signature covers the whole header, the version too */
+	hdr->version.build++;
+	zassert_equal(image_validate(IMAGE_SLOT_PRIMARY), -EPERM);
+	hdr->version.build--;
+	zassert_ok(image_validate(IMAGE_SLOT_PRIMARY));
+
+	/* An image linked elsewhere is refused before any hashing */
+	hdr->load_addr += 0x200;
+	zassert_equal(image_validate(IMAGE_SLOT_PRIMARY), -ENOEXEC);
+}
+
+ZTEST(image_verify, test_bad_digest)
+{
+	/* The digest is checked first, the signature over it stays valid */
+	slot[HDR_SIZE + IMAGE_SIZE / 2] ^= 0x80;
+	zassert_equal(image_validate(IMAGE_SLOT_PRIMARY), -EBADMSG);
+
+	/* The verdict is cached too */
+	zassert_equal(image_validate(IMAGE_SLOT_PRIMARY), -EBADMSG);
+	zassert_equal(image_verified_by(IMAGE_SLOT_PRIMARY), BOOT_VERIFY_NONE);
+}
+
+ZTEST(image_verify, test_other_key)
+{
+	psa_key_id_t other = key_add(NULL, 0);
+
+	header_sign(other);
+	zassert_equal(image_validate(IMAGE_SLOT_PRIMARY), -EPERM);
+	zassert_equal(psa_destroy_key(other), PSA_SUCCESS);
+}
+
+ZTEST(image_verify, test_latency)
+{
+	uint32_t min = UINT32_MAX, max = 0, sum = 0;
+
+	/* The first validation imports the public key, time the ones after it */
+	zassert_ok(image_validate(IMAGE_SLOT_PRIMARY));
+
+	for (int i = 0; i < LATENCY_RUNS; i++) {
+		uint64_t start;
+		uint32_t us;
+
+		image_cache_invalidate(IMAGE_SLOT_PRIMARY);
+		start = host_time_us();
+		zassert_ok(image_validate(IMAGE_SLOT_PRIMARY));
+		us = (uint32_t)(host_time_us() - start);
+
+		min = MIN(min, us);
+		max = MAX(max, us);
+		sum += us;
+	}
+
+	TC_PRINT("software PSA: digest and signature of %u bytes min %u avg %u max %u us\n",
+		 IMAGE_SIZE, min, sum / LATENCY_RUNS, max);
+}
+
+ZTEST(image_verify, test_cache_latency)
+{
+	uint32_t cold, warm;
+	uint64_t start;
+
+	/* Import the public key outside the timed runs */
+	zassert_ok(image_validate(IMAGE_SLOT_PRIMARY));
+	image_cache_invalidate(IMAGE_SLOT_PRIMARY);
+
+	/* Cold: digest and signature, and the verdict goes to the cache */
+	start = host_time_us();
+	zassert_ok(image_validate(IMAGE_SLOT_PRIMARY));
+	cold = (uint32_t)(host_time_us() - start);
+	zassert_equal(image_verified_by(IMAGE_SLOT_PRIMARY), BOOT_VERIFY_DIGEST);
+
+	/* Warm: only the header is hashed to find the record */
+	start = host_time_us();
+	zassert_ok(image_validate(IMAGE_SLOT_PRIMARY));
+	warm = (uint32_t)(host_time_us() - start);
+	zassert_equal(image_verified_by(IMAGE_SLOT_PRIMARY), BOOT_VERIFY_CACHED);
+
+	TC_PRINT("image_validate() of %u bytes: cold cache %u us, warm cache %u us\n",
+		 IMAGE_SIZE, cold, warm);
+}
+
+ZTEST_SUITE(image_verify, NULL, image_verify_setup, image_verify_before, NULL, NULL);
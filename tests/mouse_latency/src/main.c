@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "mouse_latency.h"
+
+/* CPURAD core clock, the DWT counts in it */
+#define CLOCK_HZ		320000000U
+#define US(us)			((uint32_t)(us) * (CLOCK_HZ / USEC_PER_SEC))
+
+BUILD_ASSERT(DT_PROP(DT_NODELABEL(hid_dev_0), in_polling_period_us) == 125,
+	     "tests expect the 8 kHz polling period");
+
+static const struct mouse_latency_summary *lat;
+
+static void record(uint32_t stamp, uint32_t submit_us, uint32_t done_us, uint32_t depth)
+{
+	mouse_latency_record(stamp, stamp + US(submit_us), stamp + US(done_us), depth);
+}
+
+static void stat_check(const struct mouse_latency_stat *st, uint32_t min, uint32_t max,
+		       uint64_t sum)
+{
+	zassert_equal(st->min, min, "min %u, expected %u", st->min, min);
+	zassert_equal(st->max, max, "max %u, expected %u", st->max, max);
+	zassert_equal(st->sum, sum, "sum %llu, expected %llu",
+		      (unsigned long long)st->sum, (unsigned long long)sum);
+}
+
+static void *latency_setup(void)
+{
+	lat = mouse_latency_test_summary();
+
+	return NULL;
+}
+
+static void latency_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	mouse_latency_init(CLOCK_HZ);
+}
+
+ZTEST(mouse_latency, test_stats)
+{
+	/* The first sample sets the minimum, whatever it is */
+	record(1000, 30, 300, 3);
+	record(US(5000), 10, 100, 1);
+	record(US(9000), 20, 200, 2);
+
+	zassert_equal(lat->count, 3);
+	stat_check(&lat->submit, 10, 30, 60);
+	stat_check(&lat->done, 100, 300, 600);
+	stat_check(&lat->complete, 90, 270, 540);
+	stat_check(&lat->depth, 1, 3, 6);
+}
+
+ZTEST(mouse_latency, test_histogram)
+{
+	/* Bucket n counts reports polled within n + 1 periods */
+	static const struct {
+		uint32_t done_us;
+		uint32_t bucket;
+	} samples[] = {
+		{ 0, 0 }, { 124, 0 }, { 125, 1 }, { 249, 1 }, { 250, 2 },
+		{ 874, 6 }, { 875, 7 }, { 100000, 7 },
+	};
+	uint32_t expected[MOUSE_LATENCY_BUCKETS] = { 0 };
+
+	for (size_t i = 0; i < ARRAY_SIZE(samples); i++) {
+		record(US(i * 1000), 0, samples[i].done_us, 1);
+		expected[samples[i].bucket]++;
+	}
+
+	zassert_mem_equal(lat->hist, expected, sizeof(expected));
+}
+
+ZTEST(mouse_latency, test_counter_wrap)
+{
+	/* The DWT wraps every 13.4 s at 320 MHz, differences stay right */
+	record(0xFFFFFF00, 5, 130, 1);
+
+	stat_check(&lat->submit, 5, 5, 5);
+	stat_check(&lat->done, 130, 130, 130);
+	stat_check(&lat->complete, 125, 125, 125);
+	zassert_equal(lat->hist[1], 1);
+
+	/* Close to a full wrap, the cycles to us conversion must not overflow */
+	record(US(1000), 0, 13000000, 1);
+	zassert_equal(lat->done.max, 13000000);
+}
+
+ZTEST(mouse_latency, test_summary)
+{
+	for (int i = 0; i < CONFIG_HID_MOUSE_LATENCY_SAMPLES - 1; i++) {
+		record(US(i * 1000), 50, 500, 2);
+	}
+
+	zassert_equal(lat->count, CONFIG_HID_MOUSE_LATENCY_SAMPLES - 1);
+	zassert_equal(lat->hist[4], CONFIG_HID_MOUSE_LATENCY_SAMPLES - 1);
+
+	/* The last sample of a period logs the summary and starts over */
+	record(0, 50, 500, 2);
+	zassert_equal(lat->count, 0);
+	zassert_equal(lat->done.max, 0);
+	zassert_equal(lat->hist[4], 0);
+
+	/* No minimum carried over from the previous period */
+	record(0, 70, 700, 4);
+	stat_check(&lat->submit, 70, 70, 70);
+	stat_check(&lat->depth, 4, 4, 4);
+}
+
+ZTEST_SUITE(mouse_latency, NULL, latency_setup, latency_before, NULL, NULL);
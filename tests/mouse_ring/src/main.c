@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/random/random.h>
+#include <zephyr/ztest.h>
+
+#include "mouse_ring.h"
+
+#define STRESS_EVENTS		20000
+#define STRESS_BURST_MAX	40
+
+/* What the producer sent, in order */
+static uint8_t sent_buttons[STRESS_EVENTS];
+static uint32_t sent_count;
+static int64_t sent_dx, sent_dy, sent_wheel;
+
+static struct k_timer producer_timer;
+
+static void put(uint8_t buttons, int8_t dx, int8_t dy, int8_t wheel)
+{
+	struct mouse_evt evt = {
+		.buttons = buttons,
+		.dx = dx,
+		.dy = dy,
+		.wheel = wheel,
+		.stamp = sent_count + 1,
+	};
+
+	sent_buttons[sent_count++] = buttons;
+	sent_dx += dx;
+	sent_dy += dy;
+	sent_wheel += wheel;
+
+	mouse_ring_put(&evt);
+}
+
+/* Everything still queued, as the report loop would send it */
+static void drain(struct mouse_evt *reports, size_t max, size_t *count)
+{
+	struct mouse_evt r;
+
+	while (mouse_ring_take(&r, K_NO_WAIT) == 0) {
+		zassert_true(*count < max, "more reports than expected");
+		reports[(*count)++] = r;
+	}
+}
+
+static void ring_before(void *fixture)
+{
+	struct mouse_evt r;
+
+	ARG_UNUSED(fixture);
+
+	while (mouse_ring_take(&r, K_NO_WAIT) == 0) {
+	}
+
+	sent_count = 0;
+	sent_dx = sent_dy = sent_wheel = 0;
+}
+
+ZTEST(mouse_ring, test_merge)
+{
+	struct mouse_evt reports[4];
+	size_t n = 0;
+
+	put(0, 1, 0, 0);
+	put(0, 2, -1, 0);
+	put(BIT(MOUSE_BTN_LEFT), 0, 0, 0);
+	put(BIT(MOUSE_BTN_LEFT), 3, 0, 1);
+	drain(reports, ARRAY_SIZE(reports), &n);
+
+	zassert_equal(n, 2);
+	zassert_equal(reports[0].buttons, 0);
+	zassert_equal(reports[0].dx, 3);
+	zassert_equal(reports[0].dy, -1);
+	zassert_equal(reports[0].stamp, 1, "stamp of the oldest event");
+	zassert_equal(reports[1].buttons, BIT(MOUSE_BTN_LEFT));
+	zassert_equal(reports[1].dx, 3);
+	zassert_equal(reports[1].wheel, 1);
+	zassert_equal(reports[1].stamp, 3);
+}
+
+ZTEST(mouse_ring, test_clamp)
+{
+	struct mouse_evt reports[4];
+	size_t n = 0;
+
+	for (int i = 0; i < 3; i++) {
+		put(0, 100, -100, 0);
+	}
+	drain(reports, ARRAY_SIZE(reports), &n);
+
+	zassert_equal(n, 3);
+	zassert_equal(reports[0].dx, 127);
+	zassert_equal(reports[1].dx, 127);
+	zassert_equal(reports[2].dx, 46);
+	zassert_equal(reports[2].dy, -46);
+}
+
+/* A release that only made it into the overflow must still be reported */
+ZTEST(mouse_ring, test_overflow_release)
+{
+	struct mouse_evt reports[4];
+	struct mouse_ring_stats before, after;
+	size_t n = 0;
+
+	mouse_ring_stats_get(&before);
+
+	for (int i = 0; i < 16; i++) {
+		put(BIT(MOUSE_BTN_LEFT), 1, 0, 0);
+	}
+	for (int i = 0; i < 10; i++) {
+		put(i & 1 ? 0 : BIT(MOUSE_BTN_RIGHT), 2, 0, 0);
+	}
+	drain(reports, ARRAY_SIZE(reports), &n);
+
+	mouse_ring_stats_get(&after);
+	zassert_equal(after.dropped - before.dropped, 10);
+
+	zassert_equal(n, 2);
+	zassert_equal(reports[0].buttons, BIT(MOUSE_BTN_LEFT));
+	zassert_equal(reports[0].dx, 16);
+	zassert_equal(reports[1].buttons, 0, "button stuck after overflow");
+	zassert_equal(reports[1].dx, 20);
+	zassert_equal(reports[1].stamp, 17);
+}
+
+/* Button state alone, no motion, in the overflow */
+ZTEST(mouse_ring, test_overflow_buttons_only)
+{
+	struct mouse_evt reports[4];
+	size_t n = 0;
+
+	for (int i = 0; i < 16; i++) {
+		put(0, 1, 0, 0);
+	}
+	put(BIT(MOUSE_BTN_LEFT), 0, 0, 0);
+
+	/* Nothing else arrives, the consumer must not sleep on the press */
+	drain(reports, ARRAY_SIZE(reports), &n);
+
+	zassert_equal(n, 2);
+	zassert_equal(reports[1].buttons, BIT(MOUSE_BTN_LEFT));
+	zassert_equal(reports[1].dx, 0);
+}
+
+/* Bursts from interrupt context against a slow consumer */
+static void producer_fn(struct k_timer *timer)
+{
+	static uint8_t buttons;
+	uint32_t burst = 1 + sys_rand32_get() % STRESS_BURST_MAX;
+
+	for (uint32_t i = 0; i < burst && sent_count < STRESS_EVENTS; i++) {
+		uint32_t r = sys_rand32_get();
+
+		if ((r & 0x3) == 0) {
+			buttons ^= BIT((r >> 2) & 1);
+		}
+
+		put(buttons, (int8_t)(r >> 8), (int8_t)(r >> 16), (int8_t)(r >> 24) / 16);
+	}
+
+	if (sent_count == STRESS_EVENTS) {
+		k_timer_stop(timer);
+	}
+}
+
+ZTEST(mouse_ring, test_stress)
+{
+	int64_t got_dx = 0, got_dy = 0, got_wheel = 0;
+	struct mouse_ring_stats before, after;
+	uint32_t reports = 0;
+	uint32_t match = 0;
+	uint8_t last = 0;
+	struct mouse_evt r;
+
+	mouse_ring_stats_get(&before);
+
+	k_timer_init(&producer_timer, producer_fn, NULL);
+	k_timer_start(&producer_timer, K_TICKS(1), K_TICKS(1));
+
+	while (mouse_ring_take(&r, K_MSEC(50)) == 0) {
+		/* Report buttons must follow the sent states in order */
+		while (match < sent_count && sent_buttons[match] != r.buttons) {
+			match++;
+		}
+		zassert_true(match < sent_count, "report %u has buttons 0x%x never sent",
+			     reports, r.buttons);
+
+		got_dx += r.dx;
+		got_dy += r.dy;
+		got_wheel += r.wheel;
+		last = r.buttons;
+		reports++;
+
+		/* A slow host every now and then, to overflow the ring */
+		if ((sys_rand32_get() & 0x7) == 0) {
+			k_busy_wait(500);
+		}
+	}
+
+	mouse_ring_stats_get(&after);
+
+	zassert_equal(sent_count, STRESS_EVENTS);
+	zassert_equal(after.events - before.events, STRESS_EVENTS);
+	zassert_true(after.dropped > before.dropped, "ring never overflowed");
+	zassert_equal(got_dx, sent_dx, "motion lost");
+	zassert_equal(got_dy, sent_dy, "motion lost");
+	zassert_equal(got_wheel, sent_wheel, "motion lost");
+	zassert_equal(last, sent_buttons[STRESS_EVENTS - 1], "final button state lost");
+
+	TC_PRINT("%u events, %u reports, %u merged, %u overflowed\n", STRESS_EVENTS,
+		 reports, after.merged - before.merged, after.dropped - before.dropped);
+}
+
+ZTEST_SUITE(mouse_ring, NULL, NULL, ring_before, NULL, NULL);
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <nrf_cleanup.h>
+#include <timeline.h>
+
+/* DWC2 register offsets, as in cpurad_boot/src/nrf_cleanup_core.c */
+#define GRSTCTL                 0x010
+#define GRSTCTL_CSFTRST         BIT(0)
+#define GRSTCTL_AHBIDLE         BIT(31)
+#define GINTMSK                 0x014
+#define DCTL                    0x804
+#define DCTL_SFTDISCON          BIT(1)
+#define DIEPMSK                 0x810
+#define DOEPMSK                 0x814
+#define DAINTMSK                0x81C
+
+#define REG(offs)               dwc2[(offs) / 4]
+#define NEVER                   UINT32_MAX
+
+/* Register file standing in for the USBHS core */
+static uint32_t dwc2[0x1000 / 4];
+
+/* Model of the core: when the bits the sequence waits for come up */
+static uint32_t ahb_idle_after_us;
+static uint32_t reset_done_after_us;
+
+enum step_type {
+	STEP_DELAY,
+	STEP_MARK,
+	STEP_POLL,
+};
+
+/* What the sequence did, with the registers as they were at that point */
+struct step {
+	enum step_type type;
+	uint32_t arg;
+	uint32_t dctl;
+	uint32_t grstctl;
+	uint32_t masks;
+};
+
+static struct step steps[16];
+static size_t step_count;
+
+static void step_add(enum step_type type, uint32_t arg)
+{
+	zassert_true(step_count < ARRAY_SIZE(steps));
+	steps[step_count++] = (struct step) {
+		.type = type,
+		.arg = arg,
+		.dctl = REG(DCTL),
+		.grstctl = REG(GRSTCTL),
+		.masks = REG(GINTMSK) | REG(DIEPMSK) | REG(DOEPMSK) | REG(DAINTMSK),
+	};
+}
+
+/* Override the weak ones of tests/common and record the sequence */
+void timeline_mark(enum boot_tl_stage stage)
+{
+	step_add(STEP_MARK, stage);
+}
+
+void timeline_delay_us(uint32_t us)
+{
+	step_add(STEP_DELAY, us);
+}
+
+int timeline_poll(const volatile uint32_t *reg, uint32_t mask, uint32_t expect,
+		  uint32_t timeout_us, uint32_t *waited_us)
+{
+	zassert_equal_ptr(reg, &REG(GRSTCTL));
+	step_add(STEP_POLL, mask);
+
+	for (uint32_t us = 0; us <= timeout_us; us++) {
+		if (us >= ahb_idle_after_us) {
+			REG(GRSTCTL) |= GRSTCTL_AHBIDLE;
+		}
+		if (us >= reset_done_after_us) {
+			REG(GRSTCTL) &= ~GRSTCTL_CSFTRST;
+		}
+
+		if ((*reg & mask) == expect) {
+			*waited_us = us;
+			return 0;
+		}
+	}
+
+	*waited_us = timeout_us;
+	return -ETIMEDOUT;
+}
+
+static void cleanup_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	memset(dwc2, 0, sizeof(dwc2));
+	/* Configured and running: interrupts unmasked, another DCTL bit set */
+	REG(DCTL) = BIT(2);
+	REG(GINTMSK) = 0xF77C3C3E;
+	REG(DIEPMSK) = 0x0B;
+	REG(DOEPMSK) = 0x2B;
+	REG(DAINTMSK) = 0x00030003;
+
+	ahb_idle_after_us = 3;
+	reset_done_after_us = 5;
+	step_count = 0;
+}
+
+static void expect_step(size_t i, enum step_type type, uint32_t arg)
+{
+	zassert_true(i < step_count, "only %zu steps", step_count);
+	zassert_equal(steps[i].type, type, "step %zu", i);
+	zassert_equal(steps[i].arg, arg, "step %zu", i);
+}
+
+ZTEST(nrf_cleanup, test_usb_sequence)
+{
+	zassert_ok(nrf_cleanup_usb_core((uintptr_t)dwc2));
+	zassert_equal(step_count, 5);
+
+	/* Soft disconnect first and held, other DCTL bits kept */
+	expect_step(0, STEP_DELAY, CONFIG_RAD_BOOT_USB_DISCONNECT_US);
+	zassert_equal(steps[0].dctl, DCTL_SFTDISCON | BIT(2));
+	expect_step(1, STEP_MARK, BOOT_TL_USB_DISCONNECT);
+
+	/* Interrupts masked before the reset is started */
+	expect_step(2, STEP_POLL, GRSTCTL_AHBIDLE);
+	zassert_equal(steps[2].masks, 0);
+	zassert_false(steps[2].grstctl & GRSTCTL_CSFTRST, "reset before AHB idle");
+
+	expect_step(3, STEP_POLL, GRSTCTL_CSFTRST);
+	zassert_true(steps[3].grstctl & GRSTCTL_CSFTRST);
+	expect_step(4, STEP_MARK, BOOT_TL_USB_CORE_RESET);
+
+	zassert_false(REG(GRSTCTL) & GRSTCTL_CSFTRST);
+}
+
+ZTEST(nrf_cleanup, test_usb_ahb_busy)
+{
+	/* The reset goes ahead after the bounded wait */
+	ahb_idle_after_us = NEVER;
+
+	zassert_ok(nrf_cleanup_usb_core((uintptr_t)dwc2));
+	expect_step(3, STEP_POLL, GRSTCTL_CSFTRST);
+	zassert_true(steps[3].grstctl & GRSTCTL_CSFTRST);
+}
+
+ZTEST(nrf_cleanup, test_usb_reset_stuck)
+{
+	reset_done_after_us = NEVER;
+
+	zassert_equal(nrf_cleanup_usb_core((uintptr_t)dwc2), -ETIMEDOUT);
+	/* Still stamped, the jump goes ahead */
+	expect_step(4, STEP_MARK, BOOT_TL_USB_CORE_RESET);
+}
+
+static uintptr_t reset_order[4];
+static size_t reset_count;
+
+static void record_reset(const struct nrf_cleanup_entry *entry)
+{
+	zassert_true(reset_count < ARRAY_SIZE(reset_order));
+	reset_order[reset_count++] = entry->base;
+}
+
+ZTEST(nrf_cleanup, test_table_run)
+{
+	const struct nrf_cleanup_entry table[] = {
+		{ .base = 0x1000, .reset = record_reset },
+		/* The console: left alone */
+		{ .base = 0x2000, .reset = NULL },
+		{ .base = 0x3000, .pins = BIT_MASK(12), .reset = record_reset },
+		{ .base = 0x4000, .reset = record_reset },
+	};
+
+	reset_count = 0;
+
+	nrf_cleanup_table_run(table, ARRAY_SIZE(table));
+
+	/* In table order, each with its own entry */
+	zassert_equal(reset_count, 3);
+	zassert_equal(reset_order[0], 0x1000);
+	zassert_equal(reset_order[1], 0x3000);
+	zassert_equal(reset_order[2], 0x4000);
+}
+
+ZTEST_SUITE(nrf_cleanup, NULL, NULL, cleanup_before, NULL, NULL);
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+#include <mram.h>
+#include <rollback.h>
+#include <timeline.h>
+
+#define ROLLBACK_PARTITION      DT_NODELABEL(boot_counter_partition)
+#define REC_SIZE                sizeof(struct rollback_rec)
+#define ROLLBACK_REC_COUNT      (DT_REG_SIZE(ROLLBACK_PARTITION) / REC_SIZE)
+
+static const struct flash_area *rollback_fa;
+
+/* Lose everything but the partition, like a reset does */
+static void reboot(void)
+{
+	rollback_test_reset();
+}
+
+static uint32_t counter(void)
+{
+	uint32_t value;
+
+	zassert_ok(rollback_counter_get(&value));
+	return value;
+}
+
+static void partition_read(uint32_t idx, struct rollback_rec *rec)
+{
+	zassert_ok(flash_area_read(rollback_fa, idx * REC_SIZE, rec, REC_SIZE));
+}
+
+/*
+ * Power loss while the record after the newest one is programmed: the
+ * first @p torn bytes hold the new record, the rest what was there.
+ * Returns true if the old bytes happened to match and the record is
+ * complete after all.
+ */
+static bool torn_write(uint32_t value, size_t torn)
+{
+	uint32_t head = rollback_test_head();
+	uint32_t next = (head + 1) % ROLLBACK_REC_COUNT;
+	struct rollback_rec rec;
+	uint8_t unit[REC_SIZE];
+
+	partition_read(head, &rec);
+	rec.magic = ROLLBACK_MAGIC;
+	rec.seq++;
+	rec.value = value;
+	rec.crc = crc32_ieee((const uint8_t *)&rec, offsetof(struct rollback_rec, crc));
+
+	partition_read(next, (struct rollback_rec *)unit);
+	memcpy(unit, &rec, torn);
+	zassert_ok(flash_area_write(rollback_fa, next * REC_SIZE, unit, REC_SIZE));
+
+	return memcmp(unit, &rec, REC_SIZE) == 0;
+}
+
+static void *rollback_setup(void)
+{
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(boot_counter_partition), &rollback_fa));
+
+	return NULL;
+}
+
+static void rollback_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(flash_area_flatten(rollback_fa, 0, DT_REG_SIZE(ROLLBACK_PARTITION)));
+	reboot();
+}
+
+ZTEST(rollback, test_blank_partition)
+{
+	struct image_version v = { .major = 0, .minor = 0, .revision = 0 };
+
+	zassert_equal(counter(), 0);
+	zassert_true(rollback_allows(&v));
+}
+
+ZTEST(rollback, test_raise_only)
+{
+	struct image_version old = { .major = 1, .minor = 1, .revision = 9 };
+	struct image_version cur = { .major = 1, .minor = 2, .revision = 0, .build = 7 };
+	struct mram_stats before, after;
+
+	zassert_ok(rollback_counter_set(rollback_image_value(&cur)));
+	zassert_equal(counter(), 0x01020000);
+
+	/* Equal or lower values are no-ops, not writes */
+	mram_stats_get(&before);
+	zassert_ok(rollback_counter_set(rollback_image_value(&cur)));
+	zassert_ok(rollback_counter_set(rollback_image_value(&old)));
+	mram_stats_get(&after);
+	zassert_equal(after.blocks_written, before.blocks_written);
+
+	reboot();
+	zassert_equal(counter(), 0x01020000);
+	zassert_false(rollback_allows(&old));
+	zassert_true(rollback_allows(&cur));
+}
+
+ZTEST(rollback, test_ring_wrap)
+{
+	/* Two and a half passes: every unit is reused and the head ends mid-ring */
+	uint32_t writes = ROLLBACK_REC_COUNT * 5 / 2;
+	struct rollback_rec rec;
+	uint32_t head;
+
+	for (uint32_t v = 1; v <= writes; v++) {
+		zassert_ok(rollback_counter_set(v));
+	}
+
+	reboot();
+	zassert_equal(counter(), writes);
+	head = rollback_test_head();
+	zassert_equal(head, (writes - 1) % ROLLBACK_REC_COUNT);
+
+	/* The previous record is still there, only the oldest was overwritten */
+	partition_read((head + ROLLBACK_REC_COUNT - 1) % ROLLBACK_REC_COUNT, &rec);
+	zassert_equal(rec.value, writes - 1);
+}
+
+ZTEST(rollback, test_lookup_cached)
+{
+	uint32_t cold, warm, start;
+
+	for (uint32_t v = 1; v <= ROLLBACK_REC_COUNT; v++) {
+		zassert_ok(rollback_counter_set(v));
+	}
+
+	/* Cold lookup scans the whole ring once */
+	reboot();
+	start = timeline_now();
+	zassert_equal(counter(), ROLLBACK_REC_COUNT);
+	cold = timeline_cyc_to_us(timeline_now() - start);
+
+	/* After that the value comes from RAM: wipe the ring behind its back */
+	zassert_ok(flash_area_flatten(rollback_fa, 0, DT_REG_SIZE(ROLLBACK_PARTITION)));
+	start = timeline_now();
+	for (int i = 0; i < 1000; i++) {
+		zassert_equal(counter(), ROLLBACK_REC_COUNT);
+	}
+	warm = timeline_cyc_to_us(timeline_now() - start);
+
+	TC_PRINT("%u records: cold lookup %u us, 1000 cached lookups %u us\n",
+		 (uint32_t)ROLLBACK_REC_COUNT, cold, warm);
+}
+
+ZTEST(rollback, test_power_loss)
+{
+	/* Once on a blank unit, once on a unit holding an old record */
+	uint32_t fill[] = { 3, ROLLBACK_REC_COUNT + 3 };
+
+	for (size_t f = 0; f < ARRAY_SIZE(fill); f++) {
+		zassert_ok(flash_area_flatten(rollback_fa, 0, DT_REG_SIZE(ROLLBACK_PARTITION)));
+		reboot();
+
+		for (uint32_t v = 1; v <= fill[f]; v++) {
+			zassert_ok(rollback_counter_set(v));
+		}
+
+		for (size_t torn = 0; torn < REC_SIZE; torn++) {
+			uint32_t cur = counter();
+			bool complete = torn_write(cur + 100, torn);
+
+			/* The torn record fails its CRC, the previous value holds */
+			reboot();
+			zassert_equal(counter(), complete ? cur + 100 : cur,
+				      "torn after %zu bytes", torn);
+			cur = counter();
+
+			/* And the next update goes over the torn unit */
+			zassert_ok(rollback_counter_set(cur + 1));
+			reboot();
+			zassert_equal(counter(), cur + 1, "update after %zu torn bytes", torn);
+		}
+	}
+}
+
+ZTEST_SUITE(rollback, NULL, rollback_setup, rollback_before, NULL, NULL);
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/flash/flash_simulator.h>
+#include <zephyr/storage/flash_map.h>
+#include <psa/crypto.h>
+#include <host_time.h>
+#include <image.h>
+#include <mram.h>
+#include <swap.h>
+
+#define WRITE_BLOCK             16
+#define HDR_SIZE                0x200
+/* The new image is the larger one, the swap covers all of it */
+#define OLD_SIZE                (HDR_SIZE + 40000)
+#define NEW_SIZE                (HDR_SIZE + 52000)
+#define NEVER                   UINT32_MAX
+
+static uint8_t old_image[OLD_SIZE] __aligned(4);
+static uint8_t new_image[NEW_SIZE] __aligned(4);
+static uint8_t readback[1024];
+static const struct flash_area *slot_fa[IMAGE_SLOT_COUNT];
+static const struct flash_area *journal_fa;
+
+/* Stands in for cpurad_boot/src/mram.c. Write number cut_at is torn
+ * half way and fails, as if the power went while it was programmed.
+ */
+static uint32_t writes;
+static uint32_t blocks;
+static uint32_t cut_at = NEVER;
+static uint64_t first_write_us;
+/* Write the current case was cut at, for failure messages */
+static uint32_t cut_case = NEVER;
+
+int mram_write(const struct flash_area *fa, off_t off, const void *data, size_t len)
+{
+	if (first_write_us == 0) {
+		first_write_us = host_time_us();
+	}
+
+	if (writes++ == cut_at) {
+		size_t torn = ROUND_DOWN(len / 2, WRITE_BLOCK);
+
+		if (torn != 0) {
+			zassert_ok(flash_area_write(fa, off, data, torn));
+		}
+		return -EIO;
+	}
+
+	blocks += len / WRITE_BLOCK;
+
+	return flash_area_write(fa, off, data, len);
+}
+
+void mram_stats_get(struct mram_stats *stats)
+{
+	stats->blocks_written = blocks;
+	stats->blocks_skipped = 0;
+}
+
+static void image_build(uint8_t *buf, size_t size, uint8_t major, uint8_t seed)
+{
+	struct image_header *hdr = (struct image_header *)buf;
+	size_t len;
+
+	memset(buf, 0xFF, HDR_SIZE);
+	for (size_t i = HDR_SIZE; i < size; i++) {
+		buf[i] = (uint8_t)(i * seed + (i >> 9));
+	}
+
+	hdr->magic = IMAGE_MAGIC;
+	hdr->hdr_size = HDR_SIZE;
+	hdr->flags = 0;
+	hdr->img_size = size - HDR_SIZE;
+	hdr->load_addr = image_load_addr(IMAGE_SLOT_PRIMARY);
+	hdr->version = (struct image_version) { .major = major };
+	zassert_equal(psa_hash_compute(PSA_ALG_SHA_256, buf + HDR_SIZE, hdr->img_size,
+				       hdr->sha256, sizeof(hdr->sha256), &len), PSA_SUCCESS);
+}
+
+static void slot_check(enum image_slot slot, const uint8_t *expect, size_t size)
+{
+	for (size_t off = 0; off < size; off += sizeof(readback)) {
+		size_t n = MIN(sizeof(readback), size - off);
+
+		zassert_ok(flash_area_read(slot_fa[slot], off, readback, n));
+		zassert_mem_equal(readback, &expect[off], n, "slot %d at %zu, cut at %u",
+				  slot, off, cut_case);
+	}
+}
+
+static void *swap_setup(void)
+{
+	const struct device *flash = DEVICE_DT_GET(DT_PARENT(DT_NODELABEL(flash0)));
+	size_t size;
+
+	image_test_map(flash_simulator_get_memory(flash, &size));
+	zassert_equal(psa_crypto_init(), PSA_SUCCESS);
+
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(cpurad_app_partition),
+				   &slot_fa[IMAGE_SLOT_PRIMARY]));
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(cpurad_app2_partition),
+				   &slot_fa[IMAGE_SLOT_SECONDARY]));
+	zassert_ok(flash_area_open(FIXED_PARTITION_ID(boot_journal_partition), &journal_fa));
+
+	image_build(old_image, OLD_SIZE, 1, 7);
+	image_build(new_image, NEW_SIZE, 2, 13);
+
+	return NULL;
+}
+
+/* Old image running, new one downloaded, no swap in progress */
+static void swap_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_ok(flash_area_flatten(slot_fa[IMAGE_SLOT_PRIMARY], 0,
+				      slot_fa[IMAGE_SLOT_PRIMARY]->fa_size));
+	zassert_ok(flash_area_flatten(slot_fa[IMAGE_SLOT_SECONDARY], 0,
+				      slot_fa[IMAGE_SLOT_SECONDARY]->fa_size));
+	zassert_ok(flash_area_flatten(journal_fa, 0, journal_fa->fa_size));
+	zassert_ok(flash_area_write(slot_fa[IMAGE_SLOT_PRIMARY], 0, old_image, OLD_SIZE));
+	zassert_ok(flash_area_write(slot_fa[IMAGE_SLOT_SECONDARY], 0, new_image, NEW_SIZE));
+
+	writes = 0;
+	cut_at = NEVER;
+	first_write_us = 0;
+}
+
+static void swap_done_check(void)
+{
+	slot_check(IMAGE_SLOT_PRIMARY, new_image, NEW_SIZE);
+	slot_check(IMAGE_SLOT_SECONDARY, old_image, OLD_SIZE);
+
+	/* Nothing left to do on the next reset, the old image is older */
+	zassert_equal(swap_install(), -EALREADY);
+}
+
+ZTEST(swap, test_swap)
+{
+	uint64_t start = host_time_us();
+	uint32_t us;
+
+	zassert_ok(swap_install());
+	us = (uint32_t)(host_time_us() - start);
+
+	swap_done_check();
+
+	TC_PRINT("%u bytes swapped in %u us (%u KB/s), %u writes\n", NEW_SIZE, us,
+		 us ? (uint32_t)((uint64_t)NEW_SIZE * 1000000 / 1024 / us) : 0, writes);
+}
+
+/*
+ * Cut the power at every write of the swap: each copy buffer and each
+ * journal record. The next boot must finish the swap from the journal
+ * with both images intact.
+ */
+ZTEST(swap, test_power_cut)
+{
+	uint32_t total, resumed = 0;
+	uint64_t read_us = 0;
+
+	zassert_ok(swap_install());
+	total = writes;
+
+	for (uint32_t cut = 0; cut < total; cut++) {
+		uint64_t start;
+
+		swap_before(NULL);
+		cut_at = cut;
+		cut_case = cut;
+		zassert_equal(swap_install(), -EIO, "cut at %u", cut);
+
+		/* Reset: run again from what the journal says */
+		cut_at = NEVER;
+		first_write_us = 0;
+		start = host_time_us();
+		zassert_ok(swap_install(), "resume after cut at %u", cut);
+
+		/* Write 0 is the first journal record, later cuts find one */
+		if (cut > 0) {
+			read_us += first_write_us - start;
+			resumed++;
+		}
+
+		swap_done_check();
+	}
+
+	TC_PRINT("%u cuts, journal read on resume %u us on average\n", total,
+		 resumed ? (uint32_t)(read_us / resumed) : 0);
+}
+
+ZTEST_SUITE(swap, NULL, swap_setup, swap_before, NULL, NULL);